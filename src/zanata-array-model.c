@@ -0,0 +1,122 @@
+#include "config.h"
+
+#include "zanata-array-model.h"
+
+/* A read-only #GListModel over a #GPtrArray, used to hand out decoded
+   results with contiguous storage and constant-time indexed access.  */
+
+struct _ZanataArrayModel
+{
+  GObject parent_object;
+  GType item_type;
+  GPtrArray *items;
+};
+
+static void zanata_array_model_list_model_init (GListModelInterface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (ZanataArrayModel, zanata_array_model, G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (G_TYPE_LIST_MODEL,
+                                                zanata_array_model_list_model_init))
+
+static void
+zanata_array_model_finalize (GObject *object)
+{
+  ZanataArrayModel *self = ZANATA_ARRAY_MODEL (object);
+
+  g_ptr_array_unref (self->items);
+
+  G_OBJECT_CLASS (zanata_array_model_parent_class)->finalize (object);
+}
+
+static void
+zanata_array_model_class_init (ZanataArrayModelClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->finalize = zanata_array_model_finalize;
+}
+
+static void
+zanata_array_model_init (ZanataArrayModel *self)
+{
+}
+
+static GType
+zanata_array_model_get_item_type (GListModel *list)
+{
+  ZanataArrayModel *self = ZANATA_ARRAY_MODEL (list);
+
+  return self->item_type;
+}
+
+static guint
+zanata_array_model_get_n_items (GListModel *list)
+{
+  ZanataArrayModel *self = ZANATA_ARRAY_MODEL (list);
+
+  return self->items->len;
+}
+
+static gpointer
+zanata_array_model_get_item (GListModel *list,
+                             guint       position)
+{
+  ZanataArrayModel *self = ZANATA_ARRAY_MODEL (list);
+
+  if (position >= self->items->len)
+    return NULL;
+
+  return g_object_ref (g_ptr_array_index (self->items, position));
+}
+
+static void
+zanata_array_model_list_model_init (GListModelInterface *iface)
+{
+  iface->get_item_type = zanata_array_model_get_item_type;
+  iface->get_n_items = zanata_array_model_get_n_items;
+  iface->get_item = zanata_array_model_get_item;
+}
+
+/* Takes ownership of ITEMS, which must free its elements with
+   g_object_unref() and must not be modified afterwards.  */
+ZanataArrayModel *
+_zanata_array_model_new_take (GType      item_type,
+                              GPtrArray *items)
+{
+  ZanataArrayModel *model;
+
+  model = g_object_new (ZANATA_TYPE_ARRAY_MODEL, NULL);
+  model->item_type = item_type;
+  model->items = items;
+  return model;
+}
+
+/* Returns a newly allocated list holding a reference to each item, for
+   the GList based API.  */
+GList *
+_zanata_array_model_to_list (ZanataArrayModel *model)
+{
+  GList *list = NULL;
+  guint i;
+
+  for (i = model->items->len; i > 0; i--)
+    list = g_list_prepend (list,
+                           g_object_ref (g_ptr_array_index (model->items,
+                                                            i - 1)));
+  return list;
+}
+
+/* Like _zanata_array_model_to_list(), for any #GListModel.  */
+GList *
+_zanata_list_model_to_list (GListModel *model)
+{
+  GList *list = NULL;
+  guint i;
+
+  if (ZANATA_IS_ARRAY_MODEL (model))
+    return _zanata_array_model_to_list (ZANATA_ARRAY_MODEL (model));
+
+  for (i = g_list_model_get_n_items (model); i > 0; i--)
+    list = g_list_prepend (list, g_list_model_get_item (model, i - 1));
+  return list;
+}
@@ -0,0 +1,20 @@
+#ifndef ZANATA_ARRAY_MODEL_H
+#define ZANATA_ARRAY_MODEL_H
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+#define ZANATA_TYPE_ARRAY_MODEL (zanata_array_model_get_type ())
+
+G_DECLARE_FINAL_TYPE (ZanataArrayModel, zanata_array_model,
+                      ZANATA, ARRAY_MODEL, GObject)
+
+ZanataArrayModel *_zanata_array_model_new_take (GType      item_type,
+                                                GPtrArray *items);
+GList            *_zanata_array_model_to_list  (ZanataArrayModel *model);
+GList            *_zanata_list_model_to_list   (GListModel       *model);
+
+G_END_DECLS
+
+#endif  /* ZANATA_ARRAY_MODEL_H */
@@ -5,6 +5,21 @@
 static void
 zanata_authorizer_default_init (ZanataAuthorizerInterface *iface)
 {
+  /**
+   * ZanataAuthorizer::changed:
+   * @authorizer: a #ZanataAuthorizer
+   *
+   * Emitted in the main context when the URLs or credentials returned
+   * by @authorizer have changed, for example because they have been
+   * reloaded.  Implementations emit it with g_signal_emit_by_name().
+   */
+  g_signal_new ("changed",
+                G_TYPE_FROM_INTERFACE (iface),
+                G_SIGNAL_RUN_LAST,
+                0,
+                NULL, NULL,
+                NULL,
+                G_TYPE_NONE, 0);
 }
 
 G_DEFINE_INTERFACE (ZanataAuthorizer, zanata_authorizer, G_TYPE_OBJECT)
@@ -0,0 +1,124 @@
+#include "config.h"
+
+#include "zanata-cache-converter.h"
+#include "zanata-counting-converter.h"
+
+struct _ZanataCacheConverter
+{
+  GObject parent_object;
+  ZanataCache *cache;
+  gchar *key;
+  guint64 serial;
+  gsize max_size;
+
+  /* The body read so far, or NULL once it has been attached to the
+     cache or has grown past MAX_SIZE.  */
+  GByteArray *buffer;
+};
+
+static void zanata_cache_converter_converter_init (GConverterIface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (ZanataCacheConverter, zanata_cache_converter,
+                         G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (G_TYPE_CONVERTER,
+                                                zanata_cache_converter_converter_init))
+
+static void
+zanata_cache_converter_finalize (GObject *object)
+{
+  ZanataCacheConverter *self = ZANATA_CACHE_CONVERTER (object);
+
+  _zanata_cache_free (self->cache);
+  g_free (self->key);
+  if (self->buffer)
+    g_byte_array_unref (self->buffer);
+
+  G_OBJECT_CLASS (zanata_cache_converter_parent_class)->finalize (object);
+}
+
+static void
+zanata_cache_converter_class_init (ZanataCacheConverterClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->finalize = zanata_cache_converter_finalize;
+}
+
+static void
+zanata_cache_converter_init (ZanataCacheConverter *self)
+{
+}
+
+static GConverterResult
+zanata_cache_converter_convert (GConverter       *converter,
+                                const void       *inbuf,
+                                gsize             inbuf_size,
+                                void             *outbuf,
+                                gsize             outbuf_size,
+                                GConverterFlags   flags,
+                                gsize            *bytes_read,
+                                gsize            *bytes_written,
+                                GError          **error)
+{
+  ZanataCacheConverter *self = ZANATA_CACHE_CONVERTER (converter);
+  GConverterResult result;
+
+  result = _zanata_converter_copy (inbuf, inbuf_size,
+                                   outbuf, outbuf_size,
+                                   flags,
+                                   bytes_read, bytes_written,
+                                   error);
+  if (result == G_CONVERTER_ERROR || self->buffer == NULL)
+    return result;
+
+  if (self->buffer->len + *bytes_written > self->max_size)
+    {
+      g_clear_pointer (&self->buffer, g_byte_array_unref);
+      return result;
+    }
+
+  g_byte_array_append (self->buffer, outbuf, *bytes_written);
+  if (result == G_CONVERTER_FINISHED)
+    {
+      GBytes *body = g_byte_array_free_to_bytes (self->buffer);
+
+      self->buffer = NULL;
+      _zanata_cache_set_body (self->cache, self->key, self->serial, body);
+      g_bytes_unref (body);
+    }
+
+  return result;
+}
+
+static void
+zanata_cache_converter_reset (GConverter *converter)
+{
+  ZanataCacheConverter *self = ZANATA_CACHE_CONVERTER (converter);
+
+  /* The body is no longer read from the start.  */
+  g_clear_pointer (&self->buffer, g_byte_array_unref);
+}
+
+static void
+zanata_cache_converter_converter_init (GConverterIface *iface)
+{
+  iface->convert = zanata_cache_converter_convert;
+  iface->reset = zanata_cache_converter_reset;
+}
+
+GConverter *
+_zanata_cache_converter_new (ZanataCache *cache,
+                             const gchar *key,
+                             guint64      serial,
+                             gsize        max_size)
+{
+  ZanataCacheConverter *converter;
+
+  converter = g_object_new (ZANATA_TYPE_CACHE_CONVERTER, NULL);
+  converter->cache = _zanata_cache_ref (cache);
+  converter->key = g_strdup (key);
+  converter->serial = serial;
+  converter->max_size = max_size;
+  converter->buffer = g_byte_array_new ();
+  return G_CONVERTER (converter);
+}
@@ -0,0 +1,27 @@
+#ifndef ZANATA_CACHE_CONVERTER_H
+#define ZANATA_CACHE_CONVERTER_H
+
+#include <gio/gio.h>
+#include "zanata-cache.h"
+
+G_BEGIN_DECLS
+
+/* A #GConverter passing a response body through unchanged, while
+   keeping a copy of it.  Once the whole body has been read, the copy
+   is attached to the cache entry recorded for the response.  A body
+   larger than a given size, or not read to the end, is not
+   cached.  */
+
+#define ZANATA_TYPE_CACHE_CONVERTER (zanata_cache_converter_get_type ())
+
+G_DECLARE_FINAL_TYPE (ZanataCacheConverter, zanata_cache_converter,
+                      ZANATA, CACHE_CONVERTER, GObject)
+
+GConverter *_zanata_cache_converter_new (ZanataCache *cache,
+                                         const gchar *key,
+                                         guint64      serial,
+                                         gsize        max_size);
+
+G_END_DECLS
+
+#endif  /* ZANATA_CACHE_CONVERTER_H */
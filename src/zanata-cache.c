@@ -0,0 +1,544 @@
+#include "config.h"
+
+#include "zanata-cache.h"
+
+#include <glib/gstdio.h>
+
+typedef struct _CacheEntry CacheEntry;
+
+struct _CacheEntry
+{
+  ZanataCache *cache;
+  gchar *etag;
+  gchar *last_modified;
+
+  /* Decoded objects refer back to the session owning the cache, so
+     they are only cached for as long as someone else holds them.  */
+  GWeakRef decoded;
+
+  /* The body held in memory, and its link in the LRU list of bodies.
+     With a cache directory, it is only held until it has been
+     written.  */
+  GBytes *body;
+  GList *lru_link;
+
+  /* Identifies the entry to the pending write of its body.  */
+  guint64 serial;
+  gboolean writing;
+
+  /* Whether the body can be read back from the cache directory.  */
+  gboolean on_disk;
+};
+
+struct _ZanataCache
+{
+  gint ref_count;
+  GMutex mutex;
+  gchar *directory;
+  GHashTable *entries;
+  guint64 next_serial;
+
+  /* Entries holding a body, most recently used first, and the total
+     size of these bodies.  */
+  GQueue lru;
+  gsize memory_size;
+  gsize max_memory_size;
+};
+
+/* Must be called with the mutex held.  */
+static void
+drop_body (CacheEntry *entry)
+{
+  ZanataCache *cache = entry->cache;
+
+  if (entry->body == NULL)
+    return;
+
+  cache->memory_size -= g_bytes_get_size (entry->body);
+  g_queue_delete_link (&cache->lru, entry->lru_link);
+  entry->lru_link = NULL;
+  g_clear_pointer (&entry->body, g_bytes_unref);
+}
+
+/* Evicts the least recently used bodies until the memory budget is
+   met.  Bodies still being written can't be read back yet, so they
+   are kept.  Must be called with the mutex held.  */
+static void
+trim_bodies (ZanataCache *cache)
+{
+  GList *link = cache->lru.tail;
+
+  while (cache->memory_size > cache->max_memory_size && link != NULL)
+    {
+      CacheEntry *entry = link->data;
+
+      link = link->prev;
+      if (!entry->writing)
+        drop_body (entry);
+    }
+}
+
+/* Must be called with the mutex held.  */
+static void
+set_body (CacheEntry *entry,
+          GBytes     *body)
+{
+  ZanataCache *cache = entry->cache;
+
+  drop_body (entry);
+  entry->body = g_bytes_ref (body);
+  cache->memory_size += g_bytes_get_size (body);
+  g_queue_push_head (&cache->lru, entry);
+  entry->lru_link = cache->lru.head;
+  trim_bodies (cache);
+}
+
+/* Must be called with the mutex held.  */
+static void
+touch_body (CacheEntry *entry)
+{
+  ZanataCache *cache = entry->cache;
+
+  g_queue_unlink (&cache->lru, entry->lru_link);
+  g_queue_push_head_link (&cache->lru, entry->lru_link);
+}
+
+static void
+cache_entry_free (CacheEntry *entry)
+{
+  drop_body (entry);
+  g_free (entry->etag);
+  g_free (entry->last_modified);
+  g_weak_ref_clear (&entry->decoded);
+  g_slice_free (CacheEntry, entry);
+}
+
+static CacheEntry *
+cache_entry_new (ZanataCache *cache)
+{
+  CacheEntry *entry = g_slice_new0 (CacheEntry);
+
+  entry->cache = cache;
+  g_weak_ref_init (&entry->decoded, NULL);
+  entry->serial = ++cache->next_serial;
+  return entry;
+}
+
+ZanataCache *
+_zanata_cache_new (const gchar *directory,
+                   gsize        max_memory_size)
+{
+  ZanataCache *cache = g_new0 (ZanataCache, 1);
+
+  cache->ref_count = 1;
+  cache->max_memory_size = max_memory_size;
+  g_queue_init (&cache->lru);
+  g_mutex_init (&cache->mutex);
+  if (directory != NULL && *directory != '\0')
+    {
+      cache->directory = g_strdup (directory);
+      if (g_mkdir_with_parents (cache->directory, 0700) < 0)
+        g_warning ("can't create cache directory %s", cache->directory);
+    }
+  cache->entries = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                          g_free,
+                                          (GDestroyNotify) cache_entry_free);
+  return cache;
+}
+
+ZanataCache *
+_zanata_cache_ref (ZanataCache *cache)
+{
+  g_atomic_int_inc (&cache->ref_count);
+  return cache;
+}
+
+/* Drops a reference on CACHE.  Pending writes of bodies to the cache
+   directory hold their own reference.  */
+void
+_zanata_cache_free (ZanataCache *cache)
+{
+  if (!g_atomic_int_dec_and_test (&cache->ref_count))
+    return;
+
+  g_hash_table_unref (cache->entries);
+  g_free (cache->directory);
+  g_mutex_clear (&cache->mutex);
+  g_free (cache);
+}
+
+void
+_zanata_cache_set_max_memory_size (ZanataCache *cache,
+                                   gsize        max_memory_size)
+{
+  g_mutex_lock (&cache->mutex);
+  cache->max_memory_size = max_memory_size;
+  trim_bodies (cache);
+  g_mutex_unlock (&cache->mutex);
+}
+
+gboolean
+_zanata_cache_get_persistent (ZanataCache *cache)
+{
+  return cache->directory != NULL;
+}
+
+static gchar *
+build_entry_path (ZanataCache *cache,
+                  const gchar *key,
+                  const gchar *suffix)
+{
+  gchar *checksum, *name, *path;
+
+  checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA256, key, -1);
+  name = g_strconcat (checksum, suffix, NULL);
+  path = g_build_filename (cache->directory, name, NULL);
+  g_free (name);
+  g_free (checksum);
+  return path;
+}
+
+/* Must be called with the mutex held.  */
+static CacheEntry *
+lookup_entry (ZanataCache *cache,
+              const gchar *key)
+{
+  CacheEntry *entry;
+  GKeyFile *key_file;
+  gchar *path, *uri;
+
+  entry = g_hash_table_lookup (cache->entries, key);
+  if (entry != NULL || cache->directory == NULL)
+    return entry;
+
+  path = build_entry_path (cache, key, ".meta");
+  key_file = g_key_file_new ();
+  if (g_key_file_load_from_file (key_file, path, G_KEY_FILE_NONE, NULL))
+    {
+      uri = g_key_file_get_string (key_file, "entry", "uri", NULL);
+      if (g_strcmp0 (uri, key) == 0)
+        {
+          entry = cache_entry_new (cache);
+          entry->etag =
+            g_key_file_get_string (key_file, "entry", "etag", NULL);
+          entry->last_modified =
+            g_key_file_get_string (key_file, "entry", "last-modified", NULL);
+          entry->on_disk = TRUE;
+          g_hash_table_insert (cache->entries, g_strdup (key), entry);
+        }
+      g_free (uri);
+    }
+  g_key_file_unref (key_file);
+  g_free (path);
+
+  return entry;
+}
+
+/* Adds conditional headers to a request for KEY, if there is
+   something to answer a 304 response with.  */
+void
+_zanata_cache_add_validators (ZanataCache        *cache,
+                              const gchar        *key,
+                              SoupMessageHeaders *request_headers)
+{
+  CacheEntry *entry;
+  GObject *decoded = NULL;
+
+  g_mutex_lock (&cache->mutex);
+  entry = lookup_entry (cache, key);
+  if (entry != NULL)
+    decoded = g_weak_ref_get (&entry->decoded);
+  if (entry != NULL
+      && (decoded != NULL || entry->body != NULL || entry->on_disk))
+    {
+      if (entry->etag != NULL)
+        soup_message_headers_replace (request_headers,
+                                      "If-None-Match", entry->etag);
+      if (entry->last_modified != NULL)
+        soup_message_headers_replace (request_headers,
+                                      "If-Modified-Since",
+                                      entry->last_modified);
+    }
+  g_mutex_unlock (&cache->mutex);
+
+  /* Possibly the last reference, which may release the session.  */
+  g_clear_object (&decoded);
+}
+
+typedef struct _WriteData WriteData;
+
+struct _WriteData
+{
+  ZanataCache *cache;
+  gchar *key;
+  guint64 serial;
+  GKeyFile *key_file;
+};
+
+static void
+write_data_free (WriteData *data)
+{
+  _zanata_cache_free (data->cache);
+  g_free (data->key);
+  g_key_file_unref (data->key_file);
+  g_slice_free (WriteData, data);
+}
+
+static void
+write_body_cb (GObject      *source_object,
+               GAsyncResult *res,
+               gpointer      user_data)
+{
+  WriteData *data = user_data;
+  ZanataCache *cache = data->cache;
+  CacheEntry *entry;
+  GError *error = NULL;
+  gboolean written = FALSE;
+  gchar *path;
+
+  path = g_file_get_path (G_FILE (source_object));
+  if (!g_file_replace_contents_finish (G_FILE (source_object), res, NULL,
+                                       &error))
+    {
+      g_warning ("can't write cache file %s: %s", path, error->message);
+      g_error_free (error);
+    }
+  else
+    {
+      gchar *meta_path = g_strconcat (path, ".meta", NULL);
+
+      /* The metadata is only written once the body is complete.  */
+      if (!g_key_file_save_to_file (data->key_file, meta_path, &error))
+        {
+          g_warning ("can't write cache file %s: %s",
+                     meta_path, error->message);
+          g_error_free (error);
+        }
+      else
+        written = TRUE;
+      g_free (meta_path);
+    }
+  g_free (path);
+
+  /* From now on, the body is read back from the cache directory
+     instead of being held in memory, unless the entry has been
+     replaced in the meantime.  */
+  g_mutex_lock (&cache->mutex);
+  entry = g_hash_table_lookup (cache->entries, data->key);
+  if (entry != NULL && entry->serial == data->serial)
+    {
+      entry->writing = FALSE;
+      if (written)
+        {
+          entry->on_disk = TRUE;
+          drop_body (entry);
+        }
+      else
+        trim_bodies (cache);
+    }
+  g_mutex_unlock (&cache->mutex);
+
+  write_data_free (data);
+}
+
+static void
+persist_entry (ZanataCache *cache,
+               const gchar *key,
+               CacheEntry  *entry,
+               GBytes      *body)
+{
+  GKeyFile *key_file;
+  WriteData *data;
+  GFile *file;
+  gchar *path, *meta_path;
+
+  meta_path = build_entry_path (cache, key, ".meta");
+  g_unlink (meta_path);
+  g_free (meta_path);
+
+  if (entry == NULL || body == NULL)
+    return;
+
+  key_file = g_key_file_new ();
+  g_key_file_set_string (key_file, "entry", "uri", key);
+  if (entry->etag != NULL)
+    g_key_file_set_string (key_file, "entry", "etag", entry->etag);
+  if (entry->last_modified != NULL)
+    g_key_file_set_string (key_file, "entry", "last-modified",
+                           entry->last_modified);
+
+  data = g_slice_new0 (WriteData);
+  data->cache = _zanata_cache_ref (cache);
+  data->key = g_strdup (key);
+  data->serial = entry->serial;
+  data->key_file = key_file;
+  entry->writing = TRUE;
+
+  path = build_entry_path (cache, key, "");
+  file = g_file_new_for_path (path);
+  g_file_replace_contents_bytes_async (file,
+                                       body,
+                                       NULL,
+                                       FALSE,
+                                       G_FILE_CREATE_PRIVATE
+                                       | G_FILE_CREATE_REPLACE_DESTINATION,
+                                       NULL,
+                                       write_body_cb,
+                                       data);
+  g_object_unref (file);
+  g_free (path);
+}
+
+/* Must be called with the mutex held.  A body being written is kept
+   in memory regardless of the budget, so that it is not lost before
+   it can be read back.  */
+static void
+attach_body (ZanataCache *cache,
+             const gchar *key,
+             CacheEntry  *entry,
+             GBytes      *body)
+{
+  if (cache->directory != NULL)
+    persist_entry (cache, key, entry, body);
+  if (entry != NULL && body != NULL)
+    set_body (entry, body);
+}
+
+/* Records the validators of a fresh response for KEY, replacing any
+   previous entry.  BODY may be NULL if the caller is going to attach
+   the decoded object instead, or the body once it has been read with
+   _zanata_cache_set_body().
+
+   Returns: an identifier of the new entry, or 0 if the response
+   cannot be cached.  */
+guint64
+_zanata_cache_update (ZanataCache        *cache,
+                      const gchar        *key,
+                      SoupMessageHeaders *response_headers,
+                      GBytes             *body)
+{
+  const gchar *etag, *last_modified;
+  CacheEntry *entry = NULL;
+  guint64 serial = 0;
+
+  etag = soup_message_headers_get_one (response_headers, "ETag");
+  last_modified = soup_message_headers_get_one (response_headers,
+                                                "Last-Modified");
+
+  g_mutex_lock (&cache->mutex);
+  if (etag != NULL || last_modified != NULL)
+    {
+      entry = cache_entry_new (cache);
+      entry->etag = g_strdup (etag);
+      entry->last_modified = g_strdup (last_modified);
+      g_hash_table_replace (cache->entries, g_strdup (key), entry);
+      serial = entry->serial;
+    }
+  else
+    g_hash_table_remove (cache->entries, key);
+
+  attach_body (cache, key, entry, body);
+  g_mutex_unlock (&cache->mutex);
+
+  return serial;
+}
+
+/* Attaches the body of the response recorded as SERIAL by
+   _zanata_cache_update(), unless the entry has been replaced since.  */
+void
+_zanata_cache_set_body (ZanataCache *cache,
+                        const gchar *key,
+                        guint64      serial,
+                        GBytes      *body)
+{
+  CacheEntry *entry;
+
+  g_mutex_lock (&cache->mutex);
+  entry = g_hash_table_lookup (cache->entries, key);
+  if (entry != NULL && entry->serial == serial)
+    attach_body (cache, key, entry, body);
+  g_mutex_unlock (&cache->mutex);
+}
+
+/* Forgets KEY, for a response which can no longer be answered from
+   the cache.  */
+void
+_zanata_cache_remove (ZanataCache *cache,
+                      const gchar *key)
+{
+  g_mutex_lock (&cache->mutex);
+  g_hash_table_remove (cache->entries, key);
+  if (cache->directory != NULL)
+    persist_entry (cache, key, NULL, NULL);
+  g_mutex_unlock (&cache->mutex);
+}
+
+void
+_zanata_cache_set_decoded (ZanataCache *cache,
+                           const gchar *key,
+                           GObject     *decoded)
+{
+  CacheEntry *entry;
+
+  g_mutex_lock (&cache->mutex);
+  entry = g_hash_table_lookup (cache->entries, key);
+  if (entry != NULL)
+    g_weak_ref_set (&entry->decoded, decoded);
+  g_mutex_unlock (&cache->mutex);
+}
+
+/* Returns: (transfer full) (nullable): the object decoded from the
+   cached response for KEY, if it is still alive.  */
+GObject *
+_zanata_cache_get_decoded (ZanataCache *cache,
+                           const gchar *key)
+{
+  CacheEntry *entry;
+  GObject *decoded = NULL;
+
+  g_mutex_lock (&cache->mutex);
+  entry = g_hash_table_lookup (cache->entries, key);
+  if (entry != NULL)
+    decoded = g_weak_ref_get (&entry->decoded);
+  g_mutex_unlock (&cache->mutex);
+
+  return decoded;
+}
+
+/* Returns: (transfer full) (nullable): the cached response body for
+   KEY, mapped from the cache directory if it is no longer held in
+   memory.  The mapping is not kept by the cache.  */
+GBytes *
+_zanata_cache_get_body (ZanataCache *cache,
+                        const gchar *key)
+{
+  CacheEntry *entry;
+  GBytes *body = NULL;
+
+  g_mutex_lock (&cache->mutex);
+  entry = lookup_entry (cache, key);
+  if (entry != NULL && entry->body != NULL)
+    {
+      touch_body (entry);
+      body = g_bytes_ref (entry->body);
+    }
+  else if (entry != NULL && entry->on_disk)
+    {
+      GMappedFile *mapped_file;
+      gchar *path;
+
+      path = build_entry_path (cache, key, "");
+      mapped_file = g_mapped_file_new (path, FALSE, NULL);
+      if (mapped_file != NULL)
+        {
+          body = g_mapped_file_get_bytes (mapped_file);
+          g_mapped_file_unref (mapped_file);
+        }
+      else
+        entry->on_disk = FALSE;
+      g_free (path);
+    }
+  g_mutex_unlock (&cache->mutex);
+
+  return body;
+}
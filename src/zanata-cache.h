@@ -0,0 +1,51 @@
+#ifndef ZANATA_CACHE_H
+#define ZANATA_CACHE_H
+
+#include <gio/gio.h>
+#include <libsoup/soup.h>
+
+G_BEGIN_DECLS
+
+/* A conditional-request cache, keyed by request URI.  It remembers the
+   validators (ETag and Last-Modified) of responses, together with
+   either the response body or the object decoded from it, so that a
+   304 Not Modified response can be answered without parsing.  Decoded
+   objects are only weakly referenced.  Bodies
+   held in memory are bounded by a byte budget, least recently used
+   first; with a cache directory, they are only held until written
+   and then read back from disk.  */
+
+typedef struct _ZanataCache ZanataCache;
+
+ZanataCache *_zanata_cache_new             (const gchar        *directory,
+                                            gsize               max_memory_size);
+ZanataCache *_zanata_cache_ref             (ZanataCache        *cache);
+void         _zanata_cache_free            (ZanataCache        *cache);
+void         _zanata_cache_set_max_memory_size
+                                           (ZanataCache        *cache,
+                                            gsize               max_memory_size);
+gboolean     _zanata_cache_get_persistent  (ZanataCache        *cache);
+void         _zanata_cache_add_validators  (ZanataCache        *cache,
+                                            const gchar        *key,
+                                            SoupMessageHeaders *request_headers);
+guint64      _zanata_cache_update          (ZanataCache        *cache,
+                                            const gchar        *key,
+                                            SoupMessageHeaders *response_headers,
+                                            GBytes             *body);
+void         _zanata_cache_set_body        (ZanataCache        *cache,
+                                            const gchar        *key,
+                                            guint64             serial,
+                                            GBytes             *body);
+void         _zanata_cache_remove          (ZanataCache        *cache,
+                                            const gchar        *key);
+void         _zanata_cache_set_decoded     (ZanataCache        *cache,
+                                            const gchar        *key,
+                                            GObject            *decoded);
+GObject     *_zanata_cache_get_decoded     (ZanataCache        *cache,
+                                            const gchar        *key);
+GBytes      *_zanata_cache_get_body        (ZanataCache        *cache,
+                                            const gchar        *key);
+
+G_END_DECLS
+
+#endif  /* ZANATA_CACHE_H */
@@ -0,0 +1,154 @@
+#include "config.h"
+
+#include "zanata-counting-converter.h"
+
+#include <string.h>
+
+struct _ZanataCountingConverter
+{
+  GObject parent_object;
+  ZanataSession *session;
+  GConverter *inner;
+};
+
+static void zanata_counting_converter_converter_init (GConverterIface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (ZanataCountingConverter, zanata_counting_converter,
+                         G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (G_TYPE_CONVERTER,
+                                                zanata_counting_converter_converter_init))
+
+static void
+zanata_counting_converter_finalize (GObject *object)
+{
+  ZanataCountingConverter *self = ZANATA_COUNTING_CONVERTER (object);
+
+  g_object_unref (self->session);
+  g_clear_object (&self->inner);
+
+  G_OBJECT_CLASS (zanata_counting_converter_parent_class)->finalize (object);
+}
+
+static void
+zanata_counting_converter_class_init (ZanataCountingConverterClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->finalize = zanata_counting_converter_finalize;
+}
+
+static void
+zanata_counting_converter_init (ZanataCountingConverter *self)
+{
+}
+
+/* Copies as much of the input as fits, following the contract of
+   g_converter_convert().  */
+GConverterResult
+_zanata_converter_copy (const void       *inbuf,
+                        gsize             inbuf_size,
+                        void             *outbuf,
+                        gsize             outbuf_size,
+                        GConverterFlags   flags,
+                        gsize            *bytes_read,
+                        gsize            *bytes_written,
+                        GError          **error)
+{
+  gsize size;
+
+  if (inbuf_size == 0)
+    {
+      *bytes_read = *bytes_written = 0;
+      if (flags & G_CONVERTER_INPUT_AT_END)
+        return G_CONVERTER_FINISHED;
+      if (flags & G_CONVERTER_FLUSH)
+        return G_CONVERTER_FLUSHED;
+      g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_PARTIAL_INPUT,
+                           "Need more input");
+      return G_CONVERTER_ERROR;
+    }
+
+  if (outbuf_size == 0)
+    {
+      g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_NO_SPACE,
+                           "Need more room");
+      return G_CONVERTER_ERROR;
+    }
+
+  size = MIN (inbuf_size, outbuf_size);
+  memcpy (outbuf, inbuf, size);
+  *bytes_read = *bytes_written = size;
+
+  if (size == inbuf_size)
+    {
+      if (flags & G_CONVERTER_INPUT_AT_END)
+        return G_CONVERTER_FINISHED;
+      if (flags & G_CONVERTER_FLUSH)
+        return G_CONVERTER_FLUSHED;
+    }
+  return G_CONVERTER_CONVERTED;
+}
+
+static GConverterResult
+zanata_counting_converter_convert (GConverter       *converter,
+                                   const void       *inbuf,
+                                   gsize             inbuf_size,
+                                   void             *outbuf,
+                                   gsize             outbuf_size,
+                                   GConverterFlags   flags,
+                                   gsize            *bytes_read,
+                                   gsize            *bytes_written,
+                                   GError          **error)
+{
+  ZanataCountingConverter *self = ZANATA_COUNTING_CONVERTER (converter);
+  GConverterResult result;
+
+  if (self->inner)
+    result = g_converter_convert (self->inner,
+                                  inbuf, inbuf_size,
+                                  outbuf, outbuf_size,
+                                  flags,
+                                  bytes_read, bytes_written,
+                                  error);
+  else
+    result = _zanata_converter_copy (inbuf, inbuf_size,
+                                     outbuf, outbuf_size,
+                                     flags,
+                                     bytes_read, bytes_written,
+                                     error);
+
+  if (result != G_CONVERTER_ERROR
+      && (*bytes_read > 0 || *bytes_written > 0))
+    _zanata_session_add_received (self->session, *bytes_read, *bytes_written);
+
+  return result;
+}
+
+static void
+zanata_counting_converter_reset (GConverter *converter)
+{
+  ZanataCountingConverter *self = ZANATA_COUNTING_CONVERTER (converter);
+
+  if (self->inner)
+    g_converter_reset (self->inner);
+}
+
+static void
+zanata_counting_converter_converter_init (GConverterIface *iface)
+{
+  iface->convert = zanata_counting_converter_convert;
+  iface->reset = zanata_counting_converter_reset;
+}
+
+GConverter *
+_zanata_counting_converter_new (ZanataSession *session,
+                                GConverter    *inner)
+{
+  ZanataCountingConverter *converter;
+
+  converter = g_object_new (ZANATA_TYPE_COUNTING_CONVERTER, NULL);
+  converter->session = g_object_ref (session);
+  if (inner)
+    converter->inner = g_object_ref (inner);
+  return G_CONVERTER (converter);
+}
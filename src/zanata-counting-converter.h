@@ -0,0 +1,36 @@
+#ifndef ZANATA_COUNTING_CONVERTER_H
+#define ZANATA_COUNTING_CONVERTER_H
+
+#include <gio/gio.h>
+#include "zanata-session.h"
+
+G_BEGIN_DECLS
+
+/* A #GConverter decoding a response body with an inner converter, or
+   passing it through if there is none, and adding the number of bytes
+   received and produced to the transfer counters of a session.  */
+
+#define ZANATA_TYPE_COUNTING_CONVERTER (zanata_counting_converter_get_type ())
+
+G_DECLARE_FINAL_TYPE (ZanataCountingConverter, zanata_counting_converter,
+                      ZANATA, COUNTING_CONVERTER, GObject)
+
+GConverter *_zanata_counting_converter_new (ZanataSession *session,
+                                            GConverter    *inner);
+
+void        _zanata_session_add_received   (ZanataSession *session,
+                                            gsize          received,
+                                            gsize          decoded);
+
+GConverterResult _zanata_converter_copy    (const void       *inbuf,
+                                            gsize             inbuf_size,
+                                            void             *outbuf,
+                                            gsize             outbuf_size,
+                                            GConverterFlags   flags,
+                                            gsize            *bytes_read,
+                                            gsize            *bytes_written,
+                                            GError          **error);
+
+G_END_DECLS
+
+#endif  /* ZANATA_COUNTING_CONVERTER_H */
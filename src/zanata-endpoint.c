@@ -0,0 +1,111 @@
+#include "config.h"
+
+#include "zanata-endpoint.h"
+
+#include <string.h>
+
+#define MAX_PIECES 5
+
+typedef struct _Template Template;
+
+struct _Template
+{
+  /* Literal pieces, between which the arguments are inserted.  */
+  const gchar *pieces[MAX_PIECES];
+  guint n_args;
+};
+
+static const Template templates[] =
+  {
+    [ZANATA_ENDPOINT_SUGGESTIONS] =
+    { { "/rest/suggestions" }, 0 },
+    [ZANATA_ENDPOINT_PROJECTS] =
+    { { "/rest/projects" }, 0 },
+    [ZANATA_ENDPOINT_PROJECT] =
+    { { "/rest/projects/p/", "" }, 1 },
+    [ZANATA_ENDPOINT_TRANSLATIONS] =
+    { { "/rest/projects/p/", "/iterations/i/", "/r/", "/translations/", "" }, 4 }
+  };
+
+/* The total length of the literal pieces of each template.  */
+static gsize literal_lengths[G_N_ELEMENTS (templates)];
+
+static void
+init_literal_lengths (void)
+{
+  static gsize initialized = 0;
+
+  if (g_once_init_enter (&initialized))
+    {
+      guint i, j;
+
+      for (i = 0; i < G_N_ELEMENTS (templates); i++)
+        for (j = 0; j <= templates[i].n_args; j++)
+          literal_lengths[i] += strlen (templates[i].pieces[j]);
+      g_once_init_leave (&initialized, 1);
+    }
+}
+
+/* Characters allowed in a path segment without encoding: the
+   unreserved characters and the sub-delimiters of RFC 3986.  */
+static inline gboolean
+is_segment_char (guchar c)
+{
+  return g_ascii_isalnum (c) || strchr ("-._~!$&'()*+,;=", c) != NULL;
+}
+
+/* Returns PREFIX followed by the expansion of ENDPOINT with ARGS,
+   built in a single buffer sized for the worst case.  */
+gchar *
+_zanata_endpoint_expand (ZanataEndpoint       endpoint,
+                         const gchar         *prefix,
+                         const gchar * const *args)
+{
+  static const gchar hex[] = "0123456789ABCDEF";
+  const Template *template;
+  gsize prefix_length, length;
+  gchar *result, *p;
+  guint i;
+
+  g_return_val_if_fail (endpoint < G_N_ELEMENTS (templates), NULL);
+
+  init_literal_lengths ();
+  template = &templates[endpoint];
+
+  prefix_length = strlen (prefix);
+  length = prefix_length + literal_lengths[endpoint];
+  for (i = 0; i < template->n_args; i++)
+    length += strlen (args[i]) * 3;
+
+  result = g_malloc (length + 1);
+  memcpy (result, prefix, prefix_length);
+  p = result + prefix_length;
+
+  for (i = 0; i <= template->n_args; i++)
+    {
+      const gchar *piece = template->pieces[i];
+      const guchar *s;
+      gsize piece_length = strlen (piece);
+
+      memcpy (p, piece, piece_length);
+      p += piece_length;
+
+      if (i == template->n_args)
+        break;
+
+      for (s = (const guchar *) args[i]; *s; s++)
+        {
+          if (is_segment_char (*s))
+            *p++ = *s;
+          else
+            {
+              *p++ = '%';
+              *p++ = hex[*s >> 4];
+              *p++ = hex[*s & 0xf];
+            }
+        }
+    }
+  *p = '\0';
+
+  return result;
+}
@@ -0,0 +1,36 @@
+#ifndef ZANATA_ENDPOINT_H
+#define ZANATA_ENDPOINT_H
+
+#include <libsoup/soup.h>
+#include "zanata-session.h"
+
+G_BEGIN_DECLS
+
+/* REST endpoints used by the library.  Each is expanded from a
+   precompiled template, whose placeholders are filled with
+   percent-encoded path segments.  */
+
+typedef enum
+  {
+    /* /rest/suggestions */
+    ZANATA_ENDPOINT_SUGGESTIONS,
+    /* /rest/projects */
+    ZANATA_ENDPOINT_PROJECTS,
+    /* /rest/projects/p/{p} */
+    ZANATA_ENDPOINT_PROJECT,
+    /* /rest/projects/p/{p}/iterations/i/{i}/r/{r}/translations/{l} */
+    ZANATA_ENDPOINT_TRANSLATIONS
+  }
+ZanataEndpoint;
+
+gchar *_zanata_endpoint_expand (ZanataEndpoint       endpoint,
+                                const gchar         *prefix,
+                                const gchar * const *args);
+SoupURI *_zanata_session_build_endpoint
+                               (ZanataSession       *session,
+                                ZanataEndpoint       endpoint,
+                                const gchar * const *args);
+
+G_END_DECLS
+
+#endif  /* ZANATA_ENDPOINT_H */
@@ -6,7 +6,9 @@ G_BEGIN_DECLS
 typedef enum
   {
     ZANATA_ERROR_UNKNOWN,
-    ZANATA_ERROR_INVALID_RESPONSE
+    ZANATA_ERROR_INVALID_RESPONSE,
+    ZANATA_ERROR_HTTP,
+    ZANATA_ERROR_TIMED_OUT
   }
 ZanataError;
 
@@ -26,6 +28,24 @@ typedef enum
   }
 ZanataIterationStatus;
 
+typedef enum
+  {
+    ZANATA_REQUEST_PRIORITY_INTERACTIVE,
+    ZANATA_REQUEST_PRIORITY_BULK
+  }
+ZanataRequestPriority;
+
+typedef enum
+  {
+    ZANATA_CONTENT_STATE_UNKNOWN,
+    ZANATA_CONTENT_STATE_NEW,
+    ZANATA_CONTENT_STATE_NEED_REVIEW,
+    ZANATA_CONTENT_STATE_TRANSLATED,
+    ZANATA_CONTENT_STATE_APPROVED,
+    ZANATA_CONTENT_STATE_REJECTED
+  }
+ZanataContentState;
+
 G_END_DECLS
 
 #endif  /* ZANATA_ENUMS_H */
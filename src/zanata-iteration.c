@@ -2,6 +2,8 @@
 
 #include "zanata-iteration.h"
 #include "zanata-session.h"
+#include "zanata-endpoint.h"
+#include "zanata-string-pool.h"
 #include "zanata-enumtypes.h"
 #include <json-glib/json-glib.h>
 
@@ -11,6 +13,10 @@ struct _ZanataIteration
   ZanataProject *project;
   gchar *id;
   ZanataIterationStatus status;
+
+  /* The pool holding ID, if it has been interned.  Iteration ids such
+     as "master" are shared by most projects.  */
+  ZanataStringPool *pool;
 };
 
 G_DEFINE_TYPE (ZanataIteration, zanata_iteration, G_TYPE_OBJECT)
@@ -77,6 +83,28 @@ zanata_iteration_get_property (GObject    *object,
     }
 }
 
+static void
+zanata_iteration_constructed (GObject *object)
+{
+  ZanataIteration *self = ZANATA_ITERATION (object);
+  ZanataSession *session = NULL;
+
+  G_OBJECT_CLASS (zanata_iteration_parent_class)->constructed (object);
+
+  if (self->project)
+    g_object_get (self->project, "session", &session, NULL);
+  if (session && self->id)
+    {
+      gchar *id = self->id;
+
+      self->pool =
+        _zanata_string_pool_ref (_zanata_session_get_string_pool (session));
+      self->id = (gchar *) _zanata_string_pool_acquire (self->pool, id);
+      g_free (id);
+    }
+  g_clear_object (&session);
+}
+
 static void
 zanata_iteration_dispose (GObject *object)
 {
@@ -92,7 +120,13 @@ zanata_iteration_finalize (GObject *object)
 {
   ZanataIteration *self = ZANATA_ITERATION (object);
 
-  g_free (self->id);
+  if (self->pool)
+    {
+      _zanata_string_pool_release (self->pool, self->id);
+      _zanata_string_pool_unref (self->pool);
+    }
+  else
+    g_free (self->id);
 
   G_OBJECT_CLASS (zanata_iteration_parent_class)->finalize (object);
 }
@@ -103,6 +137,7 @@ zanata_iteration_class_init (ZanataIterationClass *klass)
   GObjectClass *object_class = G_OBJECT_CLASS (klass);
   object_class->set_property = zanata_iteration_set_property;
   object_class->get_property = zanata_iteration_get_property;
+  object_class->constructed = zanata_iteration_constructed;
   object_class->dispose = zanata_iteration_dispose;
   object_class->finalize = zanata_iteration_finalize;
 
@@ -143,8 +178,16 @@ get_translated_documentation_invoke_cb (GObject      *source_object,
   GTask *task = G_TASK (user_data);
   GError *error = NULL;
   GInputStream *stream;
-
-  stream = zanata_session_invoke_finish (session, res, &error);
+  GObject *cached_object;
+  gchar *cache_key;
+
+  /* The body is kept in the cache, so no decoded object is ever
+     returned.  */
+  stream = _zanata_session_send_cached_finish (session, res,
+                                               &cache_key, &cached_object,
+                                               &error);
+  g_free (cache_key);
+  g_warn_if_fail (cached_object == NULL);
   if (!stream)
     {
       g_task_return_error (task, error);
@@ -163,72 +206,63 @@ zanata_iteration_get_translated_documentation (ZanataIteration     *iteration,
                                                GCancellable        *cancellable,
                                                GAsyncReadyCallback  callback,
                                                gpointer             user_data)
+{
+  _zanata_iteration_fetch_translated_documentation (iteration,
+                                                    domain,
+                                                    locale,
+                                                    ZANATA_REQUEST_PRIORITY_INTERACTIVE,
+                                                    cancellable,
+                                                    callback,
+                                                    user_data);
+}
+
+void
+_zanata_iteration_fetch_translated_documentation (ZanataIteration       *iteration,
+                                                  const gchar           *domain,
+                                                  const gchar           *locale,
+                                                  ZanataRequestPriority  priority,
+                                                  GCancellable          *cancellable,
+                                                  GAsyncReadyCallback    callback,
+                                                  gpointer               user_data)
 {
   GTask *task;
   SoupURI *uri;
-  gchar *project_id, *iteration_id;
-  gchar *escaped_project_id, *escaped_iteration_id;
-  gchar *escaped_domain, *escaped_locale, *path;
-  GPtrArray *array;
-  ZanataParameter *parameter;
-  ZanataParameter **parameters;
+  gchar *project_id;
+  const gchar *args[4];
+  ZanataRequest *request;
   ZanataSession *session;
 
   task = g_task_new (iteration, cancellable, callback, user_data);
 
-  g_object_get (iteration->project, "id", &project_id, NULL);
-  escaped_project_id = soup_uri_encode (project_id, NULL);
-  escaped_iteration_id = soup_uri_encode (iteration->id, NULL);
-  escaped_domain = soup_uri_encode (domain, NULL);
-  escaped_locale = soup_uri_encode (locale, NULL);
-  path = g_strdup_printf ("/rest/projects/p/%s/iterations/i/%s/r/%s/translations/%s",
-                          escaped_project_id, escaped_iteration_id,
-                          escaped_domain, escaped_locale);
-  g_free (escaped_project_id);
-  g_free (escaped_iteration_id);
-  g_free (escaped_domain);
-  g_free (escaped_locale);
-
-  array =
-    g_ptr_array_new_with_free_func ((GDestroyNotify) zanata_parameter_free);
-
-  parameter = g_new0 (ZanataParameter, 1);
-  parameter->name = g_strdup ("ext");
-  parameter->value = g_strdup ("gettext");
-  g_ptr_array_add (array, parameter);
-
+  g_object_get (iteration->project,
+                "id", &project_id,
+                "session", &session,
+                NULL);
+  args[0] = project_id;
+  args[1] = iteration->id;
+  args[2] = domain;
+  args[3] = locale;
+  uri = _zanata_session_build_endpoint (session, ZANATA_ENDPOINT_TRANSLATIONS,
+                                        args);
+  g_free (project_id);
+
+  request = zanata_request_new ("GET", uri);
+  soup_uri_free (uri);
+  zanata_request_add_parameter (request, "ext", "gettext");
 #if 0
-  parameter = g_new0 (ZanataParameter, 1);
-  parameter->name = g_strdup ("ext");
-  parameter->value = g_strdup ("comment");
-  g_ptr_array_add (array, parameter);
+  zanata_request_add_parameter (request, "ext", "comment");
 #endif
-  g_ptr_array_add (array, NULL);
-
-  parameters = (ZanataParameter **) g_ptr_array_free (array, FALSE);
-
-  g_object_get (iteration->project, "session", &session, NULL);
-  uri = zanata_session_get_endpoint (session, path);
-  g_free (path);
-
-  zanata_session_invoke (session,
-                         "GET",
-                         uri,
-                         NULL,
-                         "application/json",
-                         NULL,
-                         -1,
-                         "application/json",
-                         cancellable,
-                         get_translated_documentation_invoke_cb,
-                         task);
-  soup_uri_free (uri);
+  zanata_request_set_accept (request, "application/json");
+  zanata_request_set_priority (request, priority);
+
+  _zanata_session_send_cached (session,
+                               request,
+                               TRUE,
+                               cancellable,
+                               get_translated_documentation_invoke_cb,
+                               task);
+  g_object_unref (request);
   g_object_unref (session);
-  while (*parameters)
-    {
-      zanata_parameter_free (*parameters);
-      parameters++;
-    }
 }
 
 /**
@@ -248,3 +282,87 @@ zanata_iteration_get_translated_documentation_finish (ZanataIteration  *iteratio
 
   return g_task_propagate_pointer (G_TASK (result), error);
 }
+
+static void
+open_translation_resource_cb (GObject      *source_object,
+                              GAsyncResult *res,
+                              gpointer      user_data)
+{
+  ZanataIteration *iteration = ZANATA_ITERATION (source_object);
+  GTask *task = G_TASK (user_data);
+  GError *error = NULL;
+  GInputStream *stream;
+
+  stream = zanata_iteration_get_translated_documentation_finish (iteration,
+                                                                 res,
+                                                                 &error);
+  if (!stream)
+    {
+      g_task_return_error (task, error);
+      g_object_unref (task);
+      return;
+    }
+
+  g_task_return_pointer (task,
+                         _zanata_translation_resource_new (stream),
+                         g_object_unref);
+  g_object_unref (stream);
+  g_object_unref (task);
+}
+
+/**
+ * zanata_iteration_open_translation_resource:
+ * @iteration: a #ZanataIteration
+ * @domain: the document name
+ * @locale: the locale of the translations
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: a #GAsyncReadyCallback
+ * @user_data: (nullable): a user data
+ *
+ * Starts fetching the translations of a document, like
+ * zanata_iteration_get_translated_documentation(), but decodes them
+ * into #ZanataTextFlowTarget objects as they are downloaded, instead
+ * of returning the raw JSON.  This operation is asynchronous and
+ * shall be finished with
+ * zanata_iteration_open_translation_resource_finish().
+ */
+void
+zanata_iteration_open_translation_resource (ZanataIteration     *iteration,
+                                            const gchar         *domain,
+                                            const gchar         *locale,
+                                            GCancellable        *cancellable,
+                                            GAsyncReadyCallback  callback,
+                                            gpointer             user_data)
+{
+  GTask *task;
+
+  g_return_if_fail (ZANATA_IS_ITERATION (iteration));
+
+  task = g_task_new (iteration, cancellable, callback, user_data);
+  zanata_iteration_get_translated_documentation (iteration,
+                                                 domain,
+                                                 locale,
+                                                 cancellable,
+                                                 open_translation_resource_cb,
+                                                 task);
+}
+
+/**
+ * zanata_iteration_open_translation_resource_finish:
+ * @iteration: a #ZanataIteration
+ * @result: a #GAsyncResult
+ * @error: error location
+ *
+ * Finishes zanata_iteration_open_translation_resource() operation.
+ *
+ * Returns: (transfer full): a #ZanataTranslationResource
+ */
+ZanataTranslationResource *
+zanata_iteration_open_translation_resource_finish (ZanataIteration  *iteration,
+                                                   GAsyncResult     *result,
+                                                   GError          **error)
+{
+  g_return_val_if_fail (g_task_is_valid (result, iteration), NULL);
+
+  return g_task_propagate_pointer (G_TASK (result), error);
+}
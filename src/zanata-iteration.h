@@ -2,6 +2,8 @@
 #define ZANATA_ITERATION_H
 
 #include <gio/gio.h>
+#include "zanata-enums.h"
+#include "zanata-translation-resource.h"
 
 G_BEGIN_DECLS
 
@@ -16,11 +18,34 @@ void          zanata_iteration_get_translated_documentation (ZanataIteration
                                                              GAsyncReadyCallback  callback,
                                                              gpointer             user_data);
 
+void          _zanata_iteration_fetch_translated_documentation
+                                                            (ZanataIteration     *iteration,
+                                                             const gchar         *domain,
+                                                             const gchar         *locale,
+                                                             ZanataRequestPriority
+                                                                                  priority,
+                                                             GCancellable        *cancellable,
+                                                             GAsyncReadyCallback  callback,
+                                                             gpointer             user_data);
+
 GInputStream *zanata_iteration_get_translated_documentation_finish
                                                             (ZanataIteration     *iteration,
                                                              GAsyncResult        *result,
                                                              GError             **error);
 
+void          zanata_iteration_open_translation_resource    (ZanataIteration     *iteration,
+                                                             const gchar         *domain,
+                                                             const gchar         *locale,
+                                                             GCancellable        *cancellable,
+                                                             GAsyncReadyCallback  callback,
+                                                             gpointer             user_data);
+
+ZanataTranslationResource *
+              zanata_iteration_open_translation_resource_finish
+                                                            (ZanataIteration     *iteration,
+                                                             GAsyncResult        *result,
+                                                             GError             **error);
+
 G_END_DECLS
 
 #endif  /* ZANATA_ITERATION_H */
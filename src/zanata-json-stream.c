@@ -0,0 +1,668 @@
+#include "config.h"
+
+#include "zanata-json-stream.h"
+#include "zanata-session.h"
+#include "zanata-enums.h"
+
+#include <string.h>
+
+#define READ_CHUNK_SIZE 16384
+
+typedef enum
+  {
+    MEMBER_EXPECT_KEY,
+    MEMBER_IN_KEY,
+    MEMBER_EXPECT_COLON,
+    MEMBER_EXPECT_VALUE,
+    MEMBER_IN_VALUE,
+    MEMBER_AFTER_STREAMED_VALUE
+  }
+MemberState;
+
+typedef struct _Span Span;
+
+struct _Span
+{
+  gchar *member;
+  gchar *text;
+  gsize length;
+};
+
+struct _ZanataJsonStream
+{
+  GInputStream *input;
+  gchar **streamed_members;
+  gchar *chunk;
+  gboolean eof;
+
+  /* Bytes which have been read but not yet yielded.  Everything
+     before POS has been scanned.  */
+  GByteArray *buffer;
+  gsize pos;
+
+  gchar root;
+  gint depth;
+  gint element_depth;
+  gboolean in_string;
+  gboolean escaped;
+  gboolean done;
+  gssize element_start;
+
+  MemberState member_state;
+  gssize key_start;
+  gchar *key;
+  const gchar *streaming_member;
+
+  GQueue spans;
+  JsonParser *parser;
+  gchar *member;
+};
+
+static void
+span_free (Span *span)
+{
+  g_free (span->member);
+  g_free (span->text);
+  g_slice_free (Span, span);
+}
+
+ZanataJsonStream *
+_zanata_json_stream_new (GInputStream        *input,
+                         const gchar * const *streamed_members)
+{
+  ZanataJsonStream *stream = g_new0 (ZanataJsonStream, 1);
+
+  if (input != NULL)
+    stream->input = g_object_ref (input);
+  stream->streamed_members = g_strdupv ((gchar **) streamed_members);
+  stream->buffer = g_byte_array_new ();
+  stream->element_start = -1;
+  stream->key_start = -1;
+  g_queue_init (&stream->spans);
+  stream->parser = json_parser_new ();
+  return stream;
+}
+
+void
+_zanata_json_stream_free (ZanataJsonStream *stream)
+{
+  g_clear_object (&stream->input);
+  g_strfreev (stream->streamed_members);
+  g_free (stream->chunk);
+  g_free (stream->key);
+  g_free (stream->member);
+  g_byte_array_unref (stream->buffer);
+  g_queue_foreach (&stream->spans, (GFunc) span_free, NULL);
+  g_queue_clear (&stream->spans);
+  g_object_unref (stream->parser);
+  g_free (stream);
+}
+
+/* Returns the copy of MEMBER owned by STREAM if its array value is
+   streamed element by element, or NULL otherwise.  */
+static const gchar *
+lookup_streamed_member (ZanataJsonStream *stream,
+                        const gchar      *member)
+{
+  gchar **p;
+
+  if (stream->streamed_members == NULL || member == NULL)
+    return NULL;
+
+  for (p = stream->streamed_members; *p; p++)
+    if (strcmp (*p, member) == 0)
+      return *p;
+
+  return NULL;
+}
+
+static void
+push_span (ZanataJsonStream *stream,
+           const gchar      *member,
+           gsize             start,
+           gsize             end)
+{
+  const gchar *data = (const gchar *) stream->buffer->data;
+  Span *span;
+
+  while (end > start && g_ascii_isspace (data[end - 1]))
+    end--;
+
+  if (end == start)
+    return;
+
+  span = g_slice_new (Span);
+  span->member = g_strdup (member);
+  span->text = g_strndup (data + start, end - start);
+  span->length = end - start;
+  g_queue_push_tail (&stream->spans, span);
+}
+
+static gboolean
+set_unexpected_error (gchar    c,
+                      GError **error)
+{
+  g_set_error (error,
+               ZANATA_ERROR,
+               ZANATA_ERROR_INVALID_RESPONSE,
+               "unexpected character '%c' in JSON response", c);
+  return FALSE;
+}
+
+/* Feeds C to the state machine tracking the members of the top-level
+   object.  CONSUMED is set to FALSE if C is part of a member value and
+   still needs to be scanned.  */
+static gboolean
+scan_member (ZanataJsonStream *stream,
+             gchar             c,
+             gboolean         *consumed,
+             GError          **error)
+{
+  gsize pos = stream->pos;
+
+  *consumed = TRUE;
+  switch (stream->member_state)
+    {
+    case MEMBER_EXPECT_KEY:
+      if (c == '"')
+        {
+          stream->key_start = pos + 1;
+          stream->in_string = TRUE;
+          stream->member_state = MEMBER_IN_KEY;
+        }
+      else if (c == '}')
+        {
+          stream->depth = 0;
+          stream->done = TRUE;
+        }
+      else if (c != ',')
+        return set_unexpected_error (c, error);
+      break;
+
+    case MEMBER_IN_KEY:
+      /* The closing quote is handled in scan_buffer().  */
+      g_assert_not_reached ();
+      break;
+
+    case MEMBER_EXPECT_COLON:
+      if (c != ':')
+        return set_unexpected_error (c, error);
+      stream->member_state = MEMBER_EXPECT_VALUE;
+      break;
+
+    case MEMBER_EXPECT_VALUE:
+      if (c == '[')
+        stream->streaming_member =
+          lookup_streamed_member (stream, stream->key);
+      if (stream->streaming_member != NULL)
+        {
+          stream->depth++;
+          stream->element_depth = stream->depth;
+          stream->member_state = MEMBER_AFTER_STREAMED_VALUE;
+        }
+      else
+        {
+          stream->element_start = pos;
+          stream->member_state = MEMBER_IN_VALUE;
+          *consumed = FALSE;
+        }
+      break;
+
+    case MEMBER_IN_VALUE:
+      if (c == ',' || c == '}')
+        {
+          push_span (stream, stream->key, stream->element_start, pos);
+          stream->element_start = -1;
+          stream->member_state = MEMBER_EXPECT_KEY;
+          if (c == '}')
+            {
+              stream->depth = 0;
+              stream->done = TRUE;
+            }
+        }
+      else
+        *consumed = FALSE;
+      break;
+
+    case MEMBER_AFTER_STREAMED_VALUE:
+      if (c == ',')
+        stream->member_state = MEMBER_EXPECT_KEY;
+      else if (c == '}')
+        {
+          stream->depth = 0;
+          stream->done = TRUE;
+        }
+      else
+        return set_unexpected_error (c, error);
+      break;
+    }
+
+  return TRUE;
+}
+
+static gboolean
+scan_buffer (ZanataJsonStream *stream,
+             GError          **error)
+{
+  const gchar *data = (const gchar *) stream->buffer->data;
+
+  for (; stream->pos < stream->buffer->len; stream->pos++)
+    {
+      gchar c = data[stream->pos];
+      gboolean consumed;
+
+      if (stream->in_string)
+        {
+          if (stream->escaped)
+            stream->escaped = FALSE;
+          else if (c == '\\')
+            stream->escaped = TRUE;
+          else if (c == '"')
+            {
+              stream->in_string = FALSE;
+              if (stream->member_state == MEMBER_IN_KEY)
+                {
+                  g_free (stream->key);
+                  stream->key = g_strndup (data + stream->key_start,
+                                           stream->pos - stream->key_start);
+                  stream->key_start = -1;
+                  stream->member_state = MEMBER_EXPECT_COLON;
+                }
+            }
+          continue;
+        }
+
+      if (g_ascii_isspace (c))
+        continue;
+
+      if (stream->done)
+        return set_unexpected_error (c, error);
+
+      if (stream->root == '\0')
+        {
+          if (c != '[' && c != '{')
+            return set_unexpected_error (c, error);
+          stream->root = c;
+          stream->depth = 1;
+          stream->element_depth = 1;
+          continue;
+        }
+
+      if (stream->root == '{' && stream->depth == 1)
+        {
+          if (!scan_member (stream, c, &consumed, error))
+            return FALSE;
+          if (consumed)
+            continue;
+        }
+      else if (stream->depth == stream->element_depth)
+        {
+          /* An element of the top-level array, or of a streamed
+             member array.  */
+          if (c == ',' || c == ']')
+            {
+              if (stream->element_start >= 0)
+                push_span (stream, stream->streaming_member,
+                           stream->element_start, stream->pos);
+              stream->element_start = -1;
+              if (c == ']')
+                {
+                  stream->depth--;
+                  if (stream->streaming_member != NULL)
+                    {
+                      stream->streaming_member = NULL;
+                      stream->element_depth = 1;
+                    }
+                  else
+                    stream->done = TRUE;
+                }
+              continue;
+            }
+          if (stream->element_start < 0)
+            stream->element_start = stream->pos;
+        }
+
+      switch (c)
+        {
+        case '"':
+          stream->in_string = TRUE;
+          break;
+
+        case '{':
+        case '[':
+          stream->depth++;
+          break;
+
+        case '}':
+        case ']':
+          stream->depth--;
+          if (stream->depth < stream->element_depth)
+            return set_unexpected_error (c, error);
+          break;
+
+        default:
+          break;
+        }
+    }
+
+  return TRUE;
+}
+
+static void
+compact_buffer (ZanataJsonStream *stream)
+{
+  gsize keep;
+
+  if (stream->element_start >= 0)
+    keep = stream->element_start;
+  else if (stream->key_start >= 0)
+    keep = stream->key_start;
+  else
+    keep = stream->pos;
+
+  if (keep == 0)
+    return;
+
+  g_byte_array_remove_range (stream->buffer, 0, keep);
+  stream->pos -= keep;
+  if (stream->element_start >= 0)
+    stream->element_start -= keep;
+  if (stream->key_start >= 0)
+    stream->key_start -= keep;
+}
+
+gboolean
+_zanata_json_stream_feed (ZanataJsonStream *stream,
+                          const gchar      *data,
+                          gsize             length,
+                          GError          **error)
+{
+  g_byte_array_append (stream->buffer, (const guint8 *) data, length);
+  if (!scan_buffer (stream, error))
+    return FALSE;
+  compact_buffer (stream);
+  return TRUE;
+}
+
+gboolean
+_zanata_json_stream_close (ZanataJsonStream *stream,
+                           GError          **error)
+{
+  stream->eof = TRUE;
+  if (!stream->done)
+    {
+      g_set_error_literal (error,
+                           ZANATA_ERROR,
+                           ZANATA_ERROR_INVALID_RESPONSE,
+                           "truncated JSON response");
+      return FALSE;
+    }
+  return TRUE;
+}
+
+/* Returns the next queued value in NODE, or NULL if none has been
+   completely read yet.  NODE and MEMBER stay valid until the next
+   call.  */
+gboolean
+_zanata_json_stream_next (ZanataJsonStream  *stream,
+                          const gchar      **member,
+                          JsonNode         **node,
+                          GError           **error)
+{
+  Span *span;
+  gboolean retval;
+
+  *node = NULL;
+  if (member)
+    *member = NULL;
+
+  span = g_queue_pop_head (&stream->spans);
+  if (span == NULL)
+    return TRUE;
+
+  if (span->text[0] == '{' || span->text[0] == '[')
+    {
+      retval = json_parser_load_from_data (stream->parser,
+                                           span->text, span->length,
+                                           error);
+      if (retval)
+        *node = json_parser_get_root (stream->parser);
+    }
+  else
+    {
+      gchar *wrapped = g_strdup_printf ("[%s]", span->text);
+
+      /* Older JSON-GLib only accepts containers at the root.  */
+      retval = json_parser_load_from_data (stream->parser,
+                                           wrapped, -1,
+                                           error);
+      if (retval)
+        *node =
+          json_array_get_element (json_node_get_array (json_parser_get_root (stream->parser)), 0);
+      g_free (wrapped);
+    }
+
+  g_free (stream->member);
+  stream->member = span->member;
+  span->member = NULL;
+  if (retval && member)
+    *member = stream->member;
+
+  span_free (span);
+  return retval;
+}
+
+gboolean
+_zanata_json_stream_is_eof (ZanataJsonStream *stream)
+{
+  return stream->eof && g_queue_is_empty (&stream->spans);
+}
+
+static void
+fill_read_cb (GObject      *source_object,
+              GAsyncResult *res,
+              gpointer      user_data)
+{
+  GInputStream *input = G_INPUT_STREAM (source_object);
+  GTask *task = G_TASK (user_data);
+  ZanataJsonStream *stream = g_task_get_task_data (task);
+  GError *error = NULL;
+  gssize nread;
+
+  nread = g_input_stream_read_finish (input, res, &error);
+  if (nread < 0)
+    {
+      g_task_return_error (task, error);
+      g_object_unref (task);
+      return;
+    }
+
+  if (nread == 0)
+    {
+      if (!_zanata_json_stream_close (stream, &error))
+        g_task_return_error (task, error);
+      else
+        g_task_return_boolean (task, TRUE);
+      g_object_unref (task);
+      return;
+    }
+
+  if (!_zanata_json_stream_feed (stream, stream->chunk, nread, &error))
+    {
+      g_task_return_error (task, error);
+      g_object_unref (task);
+      return;
+    }
+
+  if (!g_queue_is_empty (&stream->spans))
+    {
+      g_task_return_boolean (task, TRUE);
+      g_object_unref (task);
+      return;
+    }
+
+  g_input_stream_read_async (stream->input,
+                             stream->chunk,
+                             READ_CHUNK_SIZE,
+                             g_task_get_priority (task),
+                             g_task_get_cancellable (task),
+                             fill_read_cb,
+                             task);
+}
+
+/* Reads from the input stream until at least one value is queued, or
+   the end of the stream is reached.  */
+static void
+fill_async (ZanataJsonStream    *stream,
+            GCancellable        *cancellable,
+            GAsyncReadyCallback  callback,
+            gpointer             user_data)
+{
+  GTask *task;
+
+  task = g_task_new (NULL, cancellable, callback, user_data);
+  g_task_set_task_data (task, stream, NULL);
+
+  if (!g_queue_is_empty (&stream->spans) || stream->eof)
+    {
+      g_task_return_boolean (task, TRUE);
+      g_object_unref (task);
+      return;
+    }
+
+  if (stream->chunk == NULL)
+    stream->chunk = g_malloc (READ_CHUNK_SIZE);
+
+  g_input_stream_read_async (stream->input,
+                             stream->chunk,
+                             READ_CHUNK_SIZE,
+                             G_PRIORITY_DEFAULT,
+                             cancellable,
+                             fill_read_cb,
+                             task);
+}
+
+static gboolean
+fill_finish (ZanataJsonStream  *stream,
+             GAsyncResult      *result,
+             GError           **error)
+{
+  g_return_val_if_fail (g_task_is_valid (result, NULL), FALSE);
+
+  return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+typedef struct _ReadData ReadData;
+
+struct _ReadData
+{
+  ZanataJsonStream *stream;
+  guint max_values;
+  guint n_values;
+  ZanataJsonStreamFunc func;
+  gpointer func_data;
+};
+
+static void
+read_data_free (ReadData *data)
+{
+  g_slice_free (ReadData, data);
+}
+
+static void read_collect (GTask *task);
+
+static void
+read_fill_cb (GObject      *source_object,
+              GAsyncResult *res,
+              gpointer      user_data)
+{
+  GTask *task = G_TASK (user_data);
+  ReadData *data = g_task_get_task_data (task);
+  GError *error = NULL;
+
+  if (!fill_finish (data->stream, res, &error))
+    {
+      g_task_return_error (task, error);
+      g_object_unref (task);
+      return;
+    }
+
+  read_collect (task);
+}
+
+static void
+read_collect (GTask *task)
+{
+  ReadData *data = g_task_get_task_data (task);
+  GError *error = NULL;
+
+  while (data->n_values < data->max_values)
+    {
+      const gchar *member;
+      JsonNode *node;
+
+      if (!_zanata_json_stream_next (data->stream, &member, &node, &error))
+        {
+          g_task_return_error (task, error);
+          g_object_unref (task);
+          return;
+        }
+
+      if (node == NULL)
+        break;
+
+      if (data->func (member, node, data->func_data))
+        data->n_values++;
+    }
+
+  if (data->n_values < data->max_values
+      && !_zanata_json_stream_is_eof (data->stream))
+    {
+      fill_async (data->stream,
+                  g_task_get_cancellable (task),
+                  read_fill_cb,
+                  task);
+      return;
+    }
+
+  g_task_return_boolean (task, TRUE);
+  g_object_unref (task);
+}
+
+/* Passes the values of STREAM to FUNC as they are downloaded, until
+   FUNC has accepted MAX_VALUES of them or the end of the document is
+   reached.  FUNC_DATA must stay valid until the operation is
+   finished.  */
+void
+_zanata_json_stream_read_async (ZanataJsonStream     *stream,
+                                guint                 max_values,
+                                ZanataJsonStreamFunc  func,
+                                gpointer              func_data,
+                                GCancellable         *cancellable,
+                                GAsyncReadyCallback   callback,
+                                gpointer              user_data)
+{
+  GTask *task;
+  ReadData *data;
+
+  task = g_task_new (NULL, cancellable, callback, user_data);
+
+  data = g_slice_new0 (ReadData);
+  data->stream = stream;
+  data->max_values = max_values;
+  data->func = func;
+  data->func_data = func_data;
+  g_task_set_task_data (task, data, (GDestroyNotify) read_data_free);
+
+  read_collect (task);
+}
+
+gboolean
+_zanata_json_stream_read_finish (ZanataJsonStream  *stream,
+                                 GAsyncResult      *result,
+                                 GError           **error)
+{
+  g_return_val_if_fail (g_task_is_valid (result, NULL), FALSE);
+
+  return g_task_propagate_boolean (G_TASK (result), error);
+}
@@ -0,0 +1,58 @@
+#ifndef ZANATA_JSON_STREAM_H
+#define ZANATA_JSON_STREAM_H
+
+#include <gio/gio.h>
+#include <json-glib/json-glib.h>
+
+G_BEGIN_DECLS
+
+/* An incremental splitter for large JSON documents.  Instead of
+   building a tree for the whole document, it yields the elements of
+   the top-level array (or the members of the top-level object) one at
+   a time, as soon as the bytes making them up have been read.  Arrays
+   held by the top-level members listed in STREAMED_MEMBERS are not
+   yielded as a whole, but element by element, with the member name
+   attached.  */
+
+typedef struct _ZanataJsonStream ZanataJsonStream;
+
+/* Called by _zanata_json_stream_read_async() for each value, with the
+   name of the streamed member holding it, if any.  Returns TRUE if
+   the value counts towards the requested number.  */
+typedef gboolean (*ZanataJsonStreamFunc) (const gchar *member,
+                                          JsonNode    *node,
+                                          gpointer     user_data);
+
+ZanataJsonStream *_zanata_json_stream_new   (GInputStream        *input,
+                                             const gchar * const *streamed_members);
+void              _zanata_json_stream_free  (ZanataJsonStream    *stream);
+
+gboolean          _zanata_json_stream_feed  (ZanataJsonStream    *stream,
+                                             const gchar         *data,
+                                             gsize                length,
+                                             GError             **error);
+gboolean          _zanata_json_stream_close (ZanataJsonStream    *stream,
+                                             GError             **error);
+gboolean          _zanata_json_stream_next  (ZanataJsonStream    *stream,
+                                             const gchar        **member,
+                                             JsonNode           **node,
+                                             GError             **error);
+gboolean          _zanata_json_stream_is_eof
+                                            (ZanataJsonStream    *stream);
+
+void              _zanata_json_stream_read_async
+                                            (ZanataJsonStream    *stream,
+                                             guint                max_values,
+                                             ZanataJsonStreamFunc func,
+                                             gpointer             func_data,
+                                             GCancellable        *cancellable,
+                                             GAsyncReadyCallback  callback,
+                                             gpointer             user_data);
+gboolean          _zanata_json_stream_read_finish
+                                            (ZanataJsonStream    *stream,
+                                             GAsyncResult        *result,
+                                             GError             **error);
+
+G_END_DECLS
+
+#endif  /* ZANATA_JSON_STREAM_H */
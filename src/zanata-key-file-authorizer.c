@@ -2,17 +2,60 @@
 
 #include <glib.h>
 #include <libsoup/soup.h>
+#include <string.h>
 #include <rest/rest-proxy-call.h>
 
 #include "zanata-authorizer.h"
 #include "zanata-key-file-authorizer.h"
 
 
+/* The credentials of every domain in the key file, resolved once.  A
+   snapshot is never modified after it has been published, so readers
+   only need to load the pointer.  */
+typedef struct _Snapshot Snapshot;
+
+struct _Snapshot
+{
+  GHashTable *credentials;
+};
+
+typedef struct _Credentials Credentials;
+
+struct _Credentials
+{
+  gchar *url;
+  gchar *username;
+  gchar *key;
+};
+
 struct _ZanataKeyFileAuthorizer
 {
   GObject parent_instance;
+
+  /* Serializes writers only.  */
   GMutex mutex;
-  GKeyFile *key_file;
+
+  Snapshot *snapshot;
+
+  /* Readers announce themselves in READERS before loading SNAPSHOT.
+     Replaced snapshots are retired, and freed by whoever next sees
+     no reader while holding the mutex, so readers never block.  */
+  gint readers;
+  GSList *retired;
+
+  /* Set when the key file is loaded from, and reloaded when it
+     changes on disk.  */
+  GFile *file;
+  GFileMonitor *monitor;
+  GMainContext *context;
+  gboolean reloading;
+  gboolean reload_pending;
+
+  /* Held across reading the file and publishing it, so that a
+     refresh and a monitor reload never publish out of order.  */
+  GMutex reload_mutex;
+
+  gboolean constructed;
 };
 
 static void zanata_authorizer_interface_init (ZanataAuthorizerInterface *iface);
@@ -24,117 +67,360 @@ G_DEFINE_TYPE_WITH_CODE (ZanataKeyFileAuthorizer, zanata_key_file_authorizer, G_
 enum {
   PROP_0,
   PROP_KEY_FILE,
+  PROP_FILE,
   LAST_PROP
 };
 
 static GParamSpec *key_file_authorizer_pspecs[LAST_PROP] = { 0 };
 
-static gchar *
-zanata_key_file_authorizer_get_url (ZanataAuthorizer *iface,
-                                    const gchar *domain)
+static void
+credentials_free (Credentials *credentials)
 {
-  ZanataKeyFileAuthorizer *self = ZANATA_KEY_FILE_AUTHORIZER (iface);
-  gchar *key, *value;
-  GError *error = NULL;
+  g_free (credentials->url);
+  g_free (credentials->username);
+  g_free (credentials->key);
+  g_slice_free (Credentials, credentials);
+}
 
-  g_mutex_lock (&self->mutex);
+static void
+snapshot_free (Snapshot *snapshot)
+{
+  g_hash_table_unref (snapshot->credentials);
+  g_slice_free (Snapshot, snapshot);
+}
+
+static Snapshot *
+snapshot_new (GKeyFile *key_file)
+{
+  Snapshot *snapshot;
+  gchar **keys;
+  gsize i;
 
-  key = g_strdup_printf ("%s.url", domain);
-  value = g_key_file_get_string (self->key_file, "servers", key, &error);
-  g_free (key);
+  snapshot = g_slice_new0 (Snapshot);
+  snapshot->credentials =
+    g_hash_table_new_full (g_str_hash, g_str_equal,
+                           g_free, (GDestroyNotify) credentials_free);
 
-  g_mutex_unlock (&self->mutex);
+  if (key_file == NULL)
+    return snapshot;
 
-  if (!value)
+  keys = g_key_file_get_keys (key_file, "servers", NULL, NULL);
+  for (i = 0; keys != NULL && keys[i] != NULL; i++)
     {
-      g_warning ("%s", error->message);
-      g_clear_error (&error);
-      return NULL;
+      const gchar *dot = strrchr (keys[i], '.');
+      Credentials *credentials;
+      gchar *domain, **field;
+
+      if (dot == NULL)
+        continue;
+
+      domain = g_strndup (keys[i], dot - keys[i]);
+      credentials = g_hash_table_lookup (snapshot->credentials, domain);
+      if (credentials == NULL)
+        {
+          credentials = g_slice_new0 (Credentials);
+          g_hash_table_insert (snapshot->credentials, domain, credentials);
+        }
+      else
+        g_free (domain);
+
+      if (strcmp (dot + 1, "url") == 0)
+        field = &credentials->url;
+      else if (strcmp (dot + 1, "username") == 0)
+        field = &credentials->username;
+      else if (strcmp (dot + 1, "key") == 0)
+        field = &credentials->key;
+      else
+        continue;
+
+      g_free (*field);
+      *field = g_key_file_get_string (key_file, "servers", keys[i], NULL);
+    }
+  g_strfreev (keys);
+
+  /* Warned about here rather than on every request.  */
+  if (g_hash_table_size (snapshot->credentials) == 0)
+    g_warning ("no credentials in key file");
+  else
+    {
+      GHashTableIter iter;
+      gpointer key, value;
+
+      g_hash_table_iter_init (&iter, snapshot->credentials);
+      while (g_hash_table_iter_next (&iter, &key, &value))
+        {
+          Credentials *credentials = value;
+
+          if (!credentials->url
+              || !credentials->username
+              || !credentials->key)
+            g_warning ("incomplete credentials for %s", (gchar *) key);
+        }
     }
 
-  return value;
+  return snapshot;
 }
 
+/* Must be called with the mutex held.  A reader which registers
+   after the check can only load the current snapshot, since no
+   writer can retire it meanwhile.  */
 static void
-zanata_key_file_authorizer_process_call (ZanataAuthorizer *iface,
-                                         const gchar *domain,
-                                         RestProxyCall *call)
+free_retired (ZanataKeyFileAuthorizer *self)
 {
-  ZanataKeyFileAuthorizer *self = ZANATA_KEY_FILE_AUTHORIZER (iface);
-  gchar *key, *value;
-  GError *error = NULL;
+  if (self->retired == NULL || g_atomic_int_get (&self->readers) > 0)
+    return;
+
+  g_slist_free_full (self->retired, (GDestroyNotify) snapshot_free);
+  self->retired = NULL;
+}
+
+/* Replaces the current snapshot, taking ownership of SNAPSHOT.  The
+   previous one is freed once no reader is active.  */
+static void
+publish_snapshot (ZanataKeyFileAuthorizer *self,
+                  Snapshot                *snapshot)
+{
+  Snapshot *old;
 
   g_mutex_lock (&self->mutex);
+  old = g_atomic_pointer_get (&self->snapshot);
+  g_atomic_pointer_set (&self->snapshot, snapshot);
+  if (old != NULL)
+    self->retired = g_slist_prepend (self->retired, old);
+  free_retired (self);
+  g_mutex_unlock (&self->mutex);
+}
+
+static Snapshot *
+enter_snapshot (ZanataKeyFileAuthorizer *self)
+{
+  g_atomic_int_inc (&self->readers);
+  return g_atomic_pointer_get (&self->snapshot);
+}
 
-  key = g_strdup_printf ("%s.username", domain);
-  value = g_key_file_get_string (self->key_file, "servers", key, &error);
-  g_free (key);
+/* The last reader out frees the retired snapshots, unless a writer
+   holds the mutex, in which case it is left to the next one.  */
+static void
+leave_snapshot (ZanataKeyFileAuthorizer *self)
+{
+  if (!g_atomic_int_dec_and_test (&self->readers))
+    return;
 
-  if (value)
-    rest_proxy_call_add_header (call, "X-Auth-User", value);
-  else
+  if (g_mutex_trylock (&self->mutex))
     {
-      g_warning ("%s", error->message);
-      g_clear_error (&error);
+      free_retired (self);
+      g_mutex_unlock (&self->mutex);
     }
-  g_free (value);
+}
 
-  key = g_strdup_printf ("%s.key", domain);
-  value = g_key_file_get_string (self->key_file, "servers", key, &error);
-  g_free (key);
+static gboolean
+emit_changed_cb (gpointer user_data)
+{
+  g_signal_emit_by_name (user_data, "changed");
+  return G_SOURCE_REMOVE;
+}
 
-  if (value)
-    rest_proxy_call_add_header (call,  "X-Auth-Token", value);
-  else
+/* Emits ::changed in the context the authorizer was created in, since
+   snapshots may be published from a worker thread.  */
+static void
+schedule_changed (ZanataKeyFileAuthorizer *self)
+{
+  g_main_context_invoke_full (self->context,
+                              G_PRIORITY_DEFAULT,
+                              emit_changed_cb,
+                              g_object_ref (self),
+                              g_object_unref);
+}
+
+static GKeyFile *
+load_key_file (GFile   *file,
+               GError **error)
+{
+  GKeyFile *key_file;
+  gchar *path;
+  gboolean loaded;
+
+  path = g_file_get_path (file);
+  if (path == NULL)
     {
-      g_warning ("%s", error->message);
-      g_clear_error (&error);
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
+                   "credentials file is not local");
+      return NULL;
     }
-  g_free (value);
 
-  g_mutex_unlock (&self->mutex);
+  key_file = g_key_file_new ();
+  loaded = g_key_file_load_from_file (key_file, path, G_KEY_FILE_NONE, error);
+  g_free (path);
+  if (!loaded)
+    {
+      g_key_file_unref (key_file);
+      return NULL;
+    }
+
+  return key_file;
+}
+
+/* Re-reads the backing file and publishes its credentials, releasing
+   the previous snapshot.  On failure, the previous credentials are
+   kept.  Called from worker threads, both by refresh_authorization()
+   and by reloads started by the file monitor.  */
+static gboolean
+reload_file (ZanataKeyFileAuthorizer  *self,
+             GError                  **error)
+{
+  GKeyFile *key_file;
+
+  g_mutex_lock (&self->reload_mutex);
+  key_file = load_key_file (self->file, error);
+  if (key_file)
+    {
+      publish_snapshot (self, snapshot_new (key_file));
+      g_key_file_unref (key_file);
+    }
+  g_mutex_unlock (&self->reload_mutex);
+
+  return key_file != NULL;
 }
 
 static void
-zanata_key_file_authorizer_process_message (ZanataAuthorizer *iface,
-                                            const gchar *domain,
-                                            SoupMessage *message)
+reload_thread_func (GTask        *task,
+                    gpointer      source_object,
+                    gpointer      task_data,
+                    GCancellable *cancellable)
 {
-  ZanataKeyFileAuthorizer *self = ZANATA_KEY_FILE_AUTHORIZER (iface);
-  gchar *key, *value;
+  ZanataKeyFileAuthorizer *self = source_object;
   GError *error = NULL;
 
-  g_mutex_lock (&self->mutex);
+  if (reload_file (self, &error))
+    g_task_return_boolean (task, TRUE);
+  else
+    g_task_return_error (task, error);
+}
 
-  key = g_strdup_printf ("%s.username", domain);
-  value = g_key_file_get_string (self->key_file, "servers", key, &error);
-  g_free (key);
+static void start_reload (ZanataKeyFileAuthorizer *self);
 
-  if (value)
-    soup_message_headers_append (message->request_headers, "X-Auth-User",
-                                 value);
+static void
+reload_cb (GObject      *source_object,
+           GAsyncResult *res,
+           gpointer      user_data)
+{
+  ZanataKeyFileAuthorizer *self = ZANATA_KEY_FILE_AUTHORIZER (source_object);
+  GError *error = NULL;
+
+  /* A half-written file keeps the previous credentials in use.  */
+  if (g_task_propagate_boolean (G_TASK (res), &error))
+    g_signal_emit_by_name (self, "changed");
   else
     {
-      g_warning ("%s", error->message);
-      g_clear_error (&error);
+      g_warning ("can't reload credentials: %s", error->message);
+      g_error_free (error);
     }
-  g_free (value);
 
-  key = g_strdup_printf ("%s.key", domain);
-  value = g_key_file_get_string (self->key_file, "servers", key, &error);
-  g_free (key);
+  self->reloading = FALSE;
+  if (self->reload_pending)
+    start_reload (self);
+}
 
-  if (value)
-    soup_message_headers_append (message->request_headers, "X-Auth-Token",
-                                 value);
-  else
+/* Editors often write a file in several steps, so changes arriving
+   during a reload are folded into a single further reload.  */
+static void
+start_reload (ZanataKeyFileAuthorizer *self)
+{
+  GTask *task;
+
+  if (self->reloading)
     {
-      g_warning ("%s", error->message);
-      g_clear_error (&error);
+      self->reload_pending = TRUE;
+      return;
     }
-  g_free (value);
 
-  g_mutex_unlock (&self->mutex);
+  self->reloading = TRUE;
+  self->reload_pending = FALSE;
+  task = g_task_new (self, NULL, reload_cb, NULL);
+  g_task_run_in_thread (task, reload_thread_func);
+  g_object_unref (task);
+}
+
+static void
+file_changed_cb (GFileMonitor      *monitor,
+                 GFile             *file,
+                 GFile             *other_file,
+                 GFileMonitorEvent  event_type,
+                 gpointer           user_data)
+{
+  switch (event_type)
+    {
+    case G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT:
+    case G_FILE_MONITOR_EVENT_CREATED:
+    case G_FILE_MONITOR_EVENT_MOVED_IN:
+    case G_FILE_MONITOR_EVENT_RENAMED:
+      start_reload (user_data);
+      break;
+
+    default:
+      break;
+    }
+}
+
+/* Missing credentials are reported when the snapshot is built, not
+   here, since this is called for every request.  A session created
+   without a domain looks up the empty one.  */
+static const Credentials *
+lookup_credentials (Snapshot    *snapshot,
+                    const gchar *domain)
+{
+  return g_hash_table_lookup (snapshot->credentials,
+                              domain != NULL ? domain : "");
+}
+
+static gchar *
+zanata_key_file_authorizer_get_url (ZanataAuthorizer *iface,
+                                    const gchar *domain)
+{
+  ZanataKeyFileAuthorizer *self = ZANATA_KEY_FILE_AUTHORIZER (iface);
+  const Credentials *credentials;
+  gchar *url = NULL;
+
+  credentials = lookup_credentials (enter_snapshot (self), domain);
+  if (credentials)
+    url = g_strdup (credentials->url);
+  leave_snapshot (self);
+
+  return url;
+}
+
+static void
+zanata_key_file_authorizer_process_call (ZanataAuthorizer *iface,
+                                         const gchar *domain,
+                                         RestProxyCall *call)
+{
+  ZanataKeyFileAuthorizer *self = ZANATA_KEY_FILE_AUTHORIZER (iface);
+  const Credentials *credentials;
+
+  credentials = lookup_credentials (enter_snapshot (self), domain);
+  if (credentials && credentials->username)
+    rest_proxy_call_add_header (call, "X-Auth-User", credentials->username);
+  if (credentials && credentials->key)
+    rest_proxy_call_add_header (call, "X-Auth-Token", credentials->key);
+  leave_snapshot (self);
+}
+
+static void
+zanata_key_file_authorizer_process_message (ZanataAuthorizer *iface,
+                                            const gchar *domain,
+                                            SoupMessage *message)
+{
+  ZanataKeyFileAuthorizer *self = ZANATA_KEY_FILE_AUTHORIZER (iface);
+  const Credentials *credentials;
+
+  credentials = lookup_credentials (enter_snapshot (self), domain);
+  if (credentials && credentials->username)
+    soup_message_headers_append (message->request_headers, "X-Auth-User",
+                                 credentials->username);
+  if (credentials && credentials->key)
+    soup_message_headers_append (message->request_headers, "X-Auth-Token",
+                                 credentials->key);
+  leave_snapshot (self);
 }
 
 static gboolean
@@ -142,6 +428,18 @@ zanata_key_file_authorizer_refresh_authorization (ZanataAuthorizer *iface,
                                                   GCancellable *cancellable,
                                                   GError **error)
 {
+  ZanataKeyFileAuthorizer *self = ZANATA_KEY_FILE_AUTHORIZER (iface);
+
+  /* This runs in a worker thread, so only the file is re-read.  A key
+     file given by the caller is resolved when it is set, on the
+     caller's thread, and is never read again.  */
+  if (!self->file)
+    return TRUE;
+
+  if (!reload_file (self, error))
+    return FALSE;
+
+  schedule_changed (self);
   return TRUE;
 }
 
@@ -150,7 +448,15 @@ zanata_key_file_authorizer_dispose (GObject *object)
 {
   ZanataKeyFileAuthorizer *self = ZANATA_KEY_FILE_AUTHORIZER (object);
 
-  g_clear_object (&self->key_file);
+  if (self->monitor)
+    {
+      g_signal_handlers_disconnect_by_func (self->monitor,
+                                            file_changed_cb,
+                                            self);
+      g_file_monitor_cancel (self->monitor);
+      g_clear_object (&self->monitor);
+    }
+  g_clear_object (&self->file);
 
   G_OBJECT_CLASS (zanata_key_file_authorizer_parent_class)->dispose (object);
 }
@@ -160,7 +466,11 @@ zanata_key_file_authorizer_finalize (GObject *object)
 {
   ZanataKeyFileAuthorizer *self = ZANATA_KEY_FILE_AUTHORIZER (object);
 
+  g_clear_pointer (&self->snapshot, snapshot_free);
+  g_slist_free_full (self->retired, (GDestroyNotify) snapshot_free);
+  g_main_context_unref (self->context);
   g_mutex_clear (&self->mutex);
+  g_mutex_clear (&self->reload_mutex);
 
   G_OBJECT_CLASS (zanata_key_file_authorizer_parent_class)->finalize (object);
 }
@@ -169,6 +479,9 @@ static void
 zanata_key_file_authorizer_init (ZanataKeyFileAuthorizer *self)
 {
   g_mutex_init (&self->mutex);
+  g_mutex_init (&self->reload_mutex);
+  self->snapshot = snapshot_new (NULL);
+  self->context = g_main_context_ref_thread_default ();
 }
 
 static void
@@ -181,10 +494,13 @@ zanata_key_file_authorizer_set_property (GObject *object,
   switch (prop_id)
     {
     case PROP_KEY_FILE:
-      g_mutex_lock (&self->mutex);
-      g_clear_pointer (&self->key_file, (GDestroyNotify) g_key_file_unref);
-      self->key_file = g_value_dup_boxed (value);
-      g_mutex_unlock (&self->mutex);
+      publish_snapshot (self, snapshot_new (g_value_get_boxed (value)));
+      if (self->constructed)
+        schedule_changed (self);
+      break;
+
+    case PROP_FILE:
+      self->file = g_value_dup_object (value);
       break;
 
     default:
@@ -193,6 +509,51 @@ zanata_key_file_authorizer_set_property (GObject *object,
     }
 }
 
+static void
+zanata_key_file_authorizer_get_property (GObject *object,
+                                         guint prop_id,
+                                         GValue *value,
+                                         GParamSpec *pspec)
+{
+  ZanataKeyFileAuthorizer *self = ZANATA_KEY_FILE_AUTHORIZER (object);
+  switch (prop_id)
+    {
+    case PROP_FILE:
+      g_value_set_object (value, self->file);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+zanata_key_file_authorizer_constructed (GObject *object)
+{
+  ZanataKeyFileAuthorizer *self = ZANATA_KEY_FILE_AUTHORIZER (object);
+  GError *error = NULL;
+
+  G_OBJECT_CLASS (zanata_key_file_authorizer_parent_class)->constructed (object);
+  self->constructed = TRUE;
+
+  if (self->file == NULL)
+    return;
+
+  self->monitor = g_file_monitor_file (self->file,
+                                       G_FILE_MONITOR_WATCH_MOVES,
+                                       NULL,
+                                       &error);
+  if (self->monitor)
+    g_signal_connect (self->monitor, "changed",
+                      G_CALLBACK (file_changed_cb), self);
+  else
+    {
+      g_warning ("can't monitor credentials file: %s", error->message);
+      g_clear_error (&error);
+    }
+}
+
 static void
 zanata_key_file_authorizer_class_init (ZanataKeyFileAuthorizerClass *class)
 {
@@ -201,6 +562,8 @@ zanata_key_file_authorizer_class_init (ZanataKeyFileAuthorizerClass *class)
   object_class->dispose = zanata_key_file_authorizer_dispose;
   object_class->finalize = zanata_key_file_authorizer_finalize;
   object_class->set_property = zanata_key_file_authorizer_set_property;
+  object_class->get_property = zanata_key_file_authorizer_get_property;
+  object_class->constructed = zanata_key_file_authorizer_constructed;
 
   key_file_authorizer_pspecs[PROP_KEY_FILE] =
     g_param_spec_boxed ("key-file",
@@ -208,6 +571,12 @@ zanata_key_file_authorizer_class_init (ZanataKeyFileAuthorizerClass *class)
                         "A key file containing Zanata credentials",
                         G_TYPE_KEY_FILE,
                         G_PARAM_WRITABLE | G_PARAM_CONSTRUCT);
+  key_file_authorizer_pspecs[PROP_FILE] =
+    g_param_spec_object ("file",
+                         "File",
+                         "A file containing Zanata credentials, reloaded when it changes",
+                         G_TYPE_FILE,
+                         G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY);
   g_object_class_install_properties (object_class, LAST_PROP,
                                      key_file_authorizer_pspecs);
 }
@@ -237,3 +606,36 @@ zanata_key_file_authorizer_new (GKeyFile *key_file)
                        "key-file", key_file,
                        NULL);
 }
+
+/**
+ * zanata_key_file_authorizer_new_for_file:
+ * @file: A #GFile containing Zanata credentials
+ * @error: error location
+ *
+ * Creates a new #ZanataKeyFileAuthorizer by loading @file.  The file
+ * is watched, and the credentials are reloaded in a worker thread
+ * whenever it changes, so that keys can be rotated without restarting.
+ * Requests are never blocked by a reload.
+ *
+ * Returns: (transfer full): A new #ZanataKeyFileAuthorizer, or %NULL
+ * if @file cannot be loaded. Free the returned object with
+ * g_object_unref().
+ */
+ZanataKeyFileAuthorizer *
+zanata_key_file_authorizer_new_for_file (GFile   *file,
+                                         GError **error)
+{
+  GKeyFile *key_file;
+  ZanataKeyFileAuthorizer *authorizer;
+
+  key_file = load_key_file (file, error);
+  if (!key_file)
+    return NULL;
+
+  authorizer = g_object_new (ZANATA_TYPE_KEY_FILE_AUTHORIZER,
+                             "key-file", key_file,
+                             "file", file,
+                             NULL);
+  g_key_file_unref (key_file);
+  return authorizer;
+}
@@ -1,7 +1,7 @@
 #ifndef ZANATA_KEY_FILE_AUTHORIZER_H
 #define ZANATA_KEY_FILE_AUTHORIZER_H
 
-#include <glib-object.h>
+#include <gio/gio.h>
 
 G_BEGIN_DECLS
 
@@ -11,6 +11,9 @@ G_DECLARE_FINAL_TYPE (ZanataKeyFileAuthorizer, zanata_key_file_authorizer,
                       ZANATA, KEY_FILE_AUTHORIZER, GObject)
 
 ZanataKeyFileAuthorizer *zanata_key_file_authorizer_new (GKeyFile *key_file);
+ZanataKeyFileAuthorizer *zanata_key_file_authorizer_new_for_file
+                                                        (GFile    *file,
+                                                         GError  **error);
 
 G_END_DECLS
 
@@ -0,0 +1,470 @@
+#include "config.h"
+
+#include "zanata-mirror.h"
+
+#define DEFAULT_MAX_CONCURRENCY 4
+
+struct _ZanataMirror
+{
+  GObject parent_object;
+  ZanataIteration *iteration;
+  gchar **documents;
+  gchar **locales;
+  guint max_concurrency;
+};
+
+G_DEFINE_TYPE (ZanataMirror, zanata_mirror, G_TYPE_OBJECT)
+
+enum {
+  PROP_0,
+  PROP_ITERATION,
+  PROP_DOCUMENTS,
+  PROP_LOCALES,
+  PROP_MAX_CONCURRENCY,
+  LAST_PROP
+};
+
+static GParamSpec *mirror_pspecs[LAST_PROP] = { 0 };
+
+enum {
+  PROGRESS,
+  ITEM_FAILED,
+  LAST_SIGNAL
+};
+
+static guint mirror_signals[LAST_SIGNAL] = { 0 };
+
+static void
+zanata_mirror_set_property (GObject      *object,
+                            guint         prop_id,
+                            const GValue *value,
+                            GParamSpec   *pspec)
+{
+  ZanataMirror *self = ZANATA_MIRROR (object);
+
+  switch (prop_id)
+    {
+    case PROP_ITERATION:
+      self->iteration = g_value_dup_object (value);
+      break;
+
+    case PROP_DOCUMENTS:
+      self->documents = g_value_dup_boxed (value);
+      break;
+
+    case PROP_LOCALES:
+      self->locales = g_value_dup_boxed (value);
+      break;
+
+    case PROP_MAX_CONCURRENCY:
+      self->max_concurrency = g_value_get_uint (value);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+zanata_mirror_get_property (GObject    *object,
+                            guint       prop_id,
+                            GValue     *value,
+                            GParamSpec *pspec)
+{
+  ZanataMirror *self = ZANATA_MIRROR (object);
+
+  switch (prop_id)
+    {
+    case PROP_ITERATION:
+      g_value_set_object (value, self->iteration);
+      break;
+
+    case PROP_DOCUMENTS:
+      g_value_set_boxed (value, self->documents);
+      break;
+
+    case PROP_LOCALES:
+      g_value_set_boxed (value, self->locales);
+      break;
+
+    case PROP_MAX_CONCURRENCY:
+      g_value_set_uint (value, self->max_concurrency);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+zanata_mirror_dispose (GObject *object)
+{
+  ZanataMirror *self = ZANATA_MIRROR (object);
+
+  g_clear_object (&self->iteration);
+
+  G_OBJECT_CLASS (zanata_mirror_parent_class)->dispose (object);
+}
+
+static void
+zanata_mirror_finalize (GObject *object)
+{
+  ZanataMirror *self = ZANATA_MIRROR (object);
+
+  g_strfreev (self->documents);
+  g_strfreev (self->locales);
+
+  G_OBJECT_CLASS (zanata_mirror_parent_class)->finalize (object);
+}
+
+static void
+zanata_mirror_class_init (ZanataMirrorClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->set_property = zanata_mirror_set_property;
+  object_class->get_property = zanata_mirror_get_property;
+  object_class->dispose = zanata_mirror_dispose;
+  object_class->finalize = zanata_mirror_finalize;
+
+  mirror_pspecs[PROP_ITERATION] =
+    g_param_spec_object ("iteration",
+                         "Iteration",
+                         "The iteration to mirror.",
+                         ZANATA_TYPE_ITERATION,
+                         G_PARAM_CONSTRUCT_ONLY | G_PARAM_READWRITE);
+  mirror_pspecs[PROP_DOCUMENTS] =
+    g_param_spec_boxed ("documents",
+                        "Documents",
+                        "The ids of the documents to download.",
+                        G_TYPE_STRV,
+                        G_PARAM_CONSTRUCT_ONLY | G_PARAM_READWRITE);
+  mirror_pspecs[PROP_LOCALES] =
+    g_param_spec_boxed ("locales",
+                        "Locales",
+                        "The locales to download each document in.",
+                        G_TYPE_STRV,
+                        G_PARAM_CONSTRUCT_ONLY | G_PARAM_READWRITE);
+  mirror_pspecs[PROP_MAX_CONCURRENCY] =
+    g_param_spec_uint ("max-concurrency",
+                       "Max concurrency",
+                       "The maximum number of downloads in flight.",
+                       1, G_MAXUINT, DEFAULT_MAX_CONCURRENCY,
+                       G_PARAM_CONSTRUCT | G_PARAM_READWRITE);
+  g_object_class_install_properties (object_class, LAST_PROP,
+                                     mirror_pspecs);
+
+  /**
+   * ZanataMirror::progress:
+   * @mirror: a #ZanataMirror
+   * @completed: the number of finished downloads, including failed ones
+   * @total: the total number of downloads
+   *
+   * Emitted each time a download finishes.
+   */
+  mirror_signals[PROGRESS] =
+    g_signal_new ("progress",
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST,
+                  0,
+                  NULL, NULL,
+                  NULL,
+                  G_TYPE_NONE, 2,
+                  G_TYPE_UINT,
+                  G_TYPE_UINT);
+
+  /**
+   * ZanataMirror::item-failed:
+   * @mirror: a #ZanataMirror
+   * @document: the document id
+   * @locale: the locale id
+   * @error: a #GError
+   *
+   * Emitted when the download of @document in @locale fails.  The
+   * other downloads are not affected.
+   */
+  mirror_signals[ITEM_FAILED] =
+    g_signal_new ("item-failed",
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST,
+                  0,
+                  NULL, NULL,
+                  NULL,
+                  G_TYPE_NONE, 3,
+                  G_TYPE_STRING,
+                  G_TYPE_STRING,
+                  G_TYPE_ERROR);
+}
+
+static void
+zanata_mirror_init (ZanataMirror *self)
+{
+}
+
+/**
+ * zanata_mirror_new:
+ * @iteration: a #ZanataIteration
+ * @documents: (array zero-terminated=1) (element-type utf8): document ids
+ * @locales: (array zero-terminated=1) (element-type utf8): locale ids
+ *
+ * Creates a mirror of the translated documentation of every document
+ * in @documents, in every locale in @locales.
+ *
+ * Returns: (transfer full): a new #ZanataMirror
+ */
+ZanataMirror *
+zanata_mirror_new (ZanataIteration     *iteration,
+                   const gchar * const *documents,
+                   const gchar * const *locales)
+{
+  return g_object_new (ZANATA_TYPE_MIRROR,
+                       "iteration", iteration,
+                       "documents", documents,
+                       "locales", locales,
+                       NULL);
+}
+
+typedef struct _RunData RunData;
+
+struct _RunData
+{
+  ZanataMirrorSinkFunc sink;
+  gpointer sink_data;
+  GDestroyNotify sink_data_destroy;
+
+  guint n_locales;
+  guint total;
+  guint next;
+  guint in_flight;
+  guint completed;
+  guint failed;
+  GError *first_error;
+};
+
+typedef struct _ItemData ItemData;
+
+struct _ItemData
+{
+  GTask *task;
+  const gchar *document;
+  const gchar *locale;
+};
+
+static void
+run_data_free (RunData *data)
+{
+  if (data->sink_data_destroy)
+    data->sink_data_destroy (data->sink_data);
+  g_clear_error (&data->first_error);
+  g_slice_free (RunData, data);
+}
+
+static void run_pump (GTask *task);
+
+static void
+item_done (ItemData *item,
+           GError   *error)
+{
+  GTask *task = item->task;
+  ZanataMirror *mirror = g_task_get_source_object (task);
+  RunData *data = g_task_get_task_data (task);
+
+  data->in_flight--;
+  data->completed++;
+
+  if (error)
+    {
+      if (!g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+        {
+          data->failed++;
+          g_signal_emit (mirror, mirror_signals[ITEM_FAILED], 0,
+                         item->document, item->locale, error);
+          if (data->first_error == NULL)
+            {
+              data->first_error = error;
+              error = NULL;
+            }
+        }
+      g_clear_error (&error);
+    }
+
+  g_signal_emit (mirror, mirror_signals[PROGRESS], 0,
+                 data->completed, data->total);
+
+  g_slice_free (ItemData, item);
+  run_pump (task);
+}
+
+static void
+item_splice_cb (GObject      *source_object,
+                GAsyncResult *res,
+                gpointer      user_data)
+{
+  ItemData *item = user_data;
+  GError *error = NULL;
+
+  g_output_stream_splice_finish (G_OUTPUT_STREAM (source_object), res, &error);
+  item_done (item, error);
+}
+
+static void
+item_fetch_cb (GObject      *source_object,
+               GAsyncResult *res,
+               gpointer      user_data)
+{
+  ZanataIteration *iteration = ZANATA_ITERATION (source_object);
+  ItemData *item = user_data;
+  ZanataMirror *mirror = g_task_get_source_object (item->task);
+  RunData *data = g_task_get_task_data (item->task);
+  GInputStream *input;
+  GOutputStream *output;
+  GError *error = NULL;
+
+  input = zanata_iteration_get_translated_documentation_finish (iteration,
+                                                                res,
+                                                                &error);
+  if (!input)
+    {
+      item_done (item, error);
+      return;
+    }
+
+  output = data->sink (mirror, item->document, item->locale,
+                       data->sink_data, &error);
+  if (!output)
+    {
+      g_object_unref (input);
+      item_done (item, error);
+      return;
+    }
+
+  g_output_stream_splice_async (output,
+                                input,
+                                G_OUTPUT_STREAM_SPLICE_CLOSE_SOURCE
+                                | G_OUTPUT_STREAM_SPLICE_CLOSE_TARGET,
+                                G_PRIORITY_DEFAULT,
+                                g_task_get_cancellable (item->task),
+                                item_splice_cb,
+                                item);
+  g_object_unref (output);
+  g_object_unref (input);
+}
+
+/* Starts downloads until the concurrency cap is reached, and completes
+   the task once nothing is left in flight.  Cancellation is
+   cooperative: no new download is started, and the ones in flight are
+   cancelled through the shared cancellable.  */
+static void
+run_pump (GTask *task)
+{
+  ZanataMirror *mirror = g_task_get_source_object (task);
+  RunData *data = g_task_get_task_data (task);
+  GCancellable *cancellable = g_task_get_cancellable (task);
+
+  while (data->in_flight < mirror->max_concurrency
+         && data->next < data->total
+         && !g_cancellable_is_cancelled (cancellable))
+    {
+      ItemData *item = g_slice_new0 (ItemData);
+
+      item->task = task;
+      item->document = mirror->documents[data->next / data->n_locales];
+      item->locale = mirror->locales[data->next % data->n_locales];
+      data->next++;
+      data->in_flight++;
+
+      _zanata_iteration_fetch_translated_documentation (mirror->iteration,
+                                                        item->document,
+                                                        item->locale,
+                                                        ZANATA_REQUEST_PRIORITY_BULK,
+                                                        cancellable,
+                                                        item_fetch_cb,
+                                                        item);
+    }
+
+  if (data->in_flight > 0)
+    return;
+
+  if (g_cancellable_is_cancelled (cancellable))
+    g_task_return_error_if_cancelled (task);
+  else if (data->failed > 0)
+    {
+      g_prefix_error (&data->first_error,
+                      "%u of %u downloads failed: ",
+                      data->failed, data->total);
+      g_task_return_error (task, data->first_error);
+      data->first_error = NULL;
+    }
+  else
+    g_task_return_boolean (task, TRUE);
+  g_object_unref (task);
+}
+
+/**
+ * zanata_mirror_run_async:
+ * @mirror: a #ZanataMirror
+ * @sink: (scope notified): a #ZanataMirrorSinkFunc
+ * @sink_data: (closure sink): user data passed to @sink
+ * @sink_data_destroy: (destroy sink_data): a #GDestroyNotify for @sink_data
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: a #GAsyncReadyCallback
+ * @user_data: (nullable): a user data
+ *
+ * Starts downloading every (document, locale) pair of @mirror, at most
+ * #ZanataMirror:max-concurrency at a time.  Each download is written
+ * to the stream returned by @sink as soon as it arrives.  A failed
+ * download is reported with #ZanataMirror::item-failed and does not
+ * stop the others.  This operation is asynchronous and shall be
+ * finished with zanata_mirror_run_finish().
+ */
+void
+zanata_mirror_run_async (ZanataMirror         *mirror,
+                         ZanataMirrorSinkFunc  sink,
+                         gpointer              sink_data,
+                         GDestroyNotify        sink_data_destroy,
+                         GCancellable         *cancellable,
+                         GAsyncReadyCallback   callback,
+                         gpointer              user_data)
+{
+  GTask *task;
+  RunData *data;
+
+  g_return_if_fail (ZANATA_IS_MIRROR (mirror));
+  g_return_if_fail (sink != NULL);
+
+  task = g_task_new (mirror, cancellable, callback, user_data);
+  data = g_slice_new0 (RunData);
+  data->sink = sink;
+  data->sink_data = sink_data;
+  data->sink_data_destroy = sink_data_destroy;
+  data->n_locales = mirror->locales ? g_strv_length (mirror->locales) : 0;
+  data->total = mirror->documents
+    ? g_strv_length (mirror->documents) * data->n_locales
+    : 0;
+  g_task_set_task_data (task, data, (GDestroyNotify) run_data_free);
+
+  run_pump (task);
+}
+
+/**
+ * zanata_mirror_run_finish:
+ * @mirror: a #ZanataMirror
+ * @result: a #GAsyncResult
+ * @error: error location
+ *
+ * Finishes zanata_mirror_run_async() operation.  If any download
+ * failed, @error is set to the first failure.
+ *
+ * Returns: %TRUE if every download was written
+ */
+gboolean
+zanata_mirror_run_finish (ZanataMirror  *mirror,
+                          GAsyncResult  *result,
+                          GError       **error)
+{
+  g_return_val_if_fail (g_task_is_valid (result, mirror), FALSE);
+
+  return g_task_propagate_boolean (G_TASK (result), error);
+}
@@ -0,0 +1,52 @@
+#ifndef ZANATA_MIRROR_H
+#define ZANATA_MIRROR_H
+
+#include <gio/gio.h>
+#include "zanata-iteration.h"
+
+G_BEGIN_DECLS
+
+#define ZANATA_TYPE_MIRROR (zanata_mirror_get_type ())
+
+G_DECLARE_FINAL_TYPE (ZanataMirror, zanata_mirror,
+                      ZANATA, MIRROR, GObject)
+
+/**
+ * ZanataMirrorSinkFunc:
+ * @mirror: a #ZanataMirror
+ * @document: the document id
+ * @locale: the locale id
+ * @user_data: user data passed to zanata_mirror_run_async()
+ * @error: error location
+ *
+ * Opens the destination of the translated documentation of @document
+ * in @locale.  The stream is closed by @mirror once the download has
+ * been written.
+ *
+ * Returns: (transfer full) (nullable): a #GOutputStream, or %NULL
+ *   with @error set
+ */
+typedef GOutputStream *(*ZanataMirrorSinkFunc) (ZanataMirror  *mirror,
+                                                const gchar   *document,
+                                                const gchar   *locale,
+                                                gpointer       user_data,
+                                                GError       **error);
+
+ZanataMirror *zanata_mirror_new        (ZanataIteration      *iteration,
+                                        const gchar * const  *documents,
+                                        const gchar * const  *locales);
+
+void          zanata_mirror_run_async  (ZanataMirror         *mirror,
+                                        ZanataMirrorSinkFunc  sink,
+                                        gpointer              sink_data,
+                                        GDestroyNotify        sink_data_destroy,
+                                        GCancellable         *cancellable,
+                                        GAsyncReadyCallback   callback,
+                                        gpointer              user_data);
+gboolean      zanata_mirror_run_finish (ZanataMirror         *mirror,
+                                        GAsyncResult         *result,
+                                        GError              **error);
+
+G_END_DECLS
+
+#endif  /* ZANATA_MIRROR_H */
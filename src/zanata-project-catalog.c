@@ -0,0 +1,464 @@
+#include "config.h"
+
+#include "zanata-project-catalog.h"
+#include "zanata-json-stream.h"
+#include "zanata-session.h"
+#include "zanata-enumdecode.h"
+
+#include <string.h>
+
+/* The catalog is stored column by column: the ids and names are
+   offsets into a single string arena, and the statuses are packed in
+   a byte array.  Only the projects requested by position are turned
+   into #ZanataProject objects.  Filtered catalogs share the arena of
+   the catalog they are derived from.  */
+
+struct _ZanataProjectCatalog
+{
+  GObject parent_object;
+  ZanataSession *session;
+
+  GByteArray *arena;
+  GArray *ids;
+  GArray *names;
+  GArray *statuses;
+
+  /* Projects materialized so far, by position.  */
+  GMutex projects_lock;
+  GHashTable *projects;
+
+  ZanataJsonStream *json;
+};
+
+static void zanata_project_catalog_list_model_init (GListModelInterface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (ZanataProjectCatalog, zanata_project_catalog,
+                         G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (G_TYPE_LIST_MODEL,
+                                                zanata_project_catalog_list_model_init))
+
+static void
+zanata_project_catalog_dispose (GObject *object)
+{
+  ZanataProjectCatalog *self = ZANATA_PROJECT_CATALOG (object);
+
+  g_hash_table_remove_all (self->projects);
+  g_clear_object (&self->session);
+
+  G_OBJECT_CLASS (zanata_project_catalog_parent_class)->dispose (object);
+}
+
+static void
+zanata_project_catalog_finalize (GObject *object)
+{
+  ZanataProjectCatalog *self = ZANATA_PROJECT_CATALOG (object);
+
+  g_byte_array_unref (self->arena);
+  g_array_unref (self->ids);
+  g_array_unref (self->names);
+  g_array_unref (self->statuses);
+  g_hash_table_unref (self->projects);
+  g_mutex_clear (&self->projects_lock);
+  g_clear_pointer (&self->json, _zanata_json_stream_free);
+
+  G_OBJECT_CLASS (zanata_project_catalog_parent_class)->finalize (object);
+}
+
+static void
+zanata_project_catalog_class_init (ZanataProjectCatalogClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->dispose = zanata_project_catalog_dispose;
+  object_class->finalize = zanata_project_catalog_finalize;
+}
+
+static void
+zanata_project_catalog_init (ZanataProjectCatalog *self)
+{
+  self->ids = g_array_new (FALSE, FALSE, sizeof (guint32));
+  self->names = g_array_new (FALSE, FALSE, sizeof (guint32));
+  self->statuses = g_array_new (FALSE, FALSE, sizeof (guint8));
+  g_mutex_init (&self->projects_lock);
+  self->projects = g_hash_table_new_full (NULL, NULL, NULL, g_object_unref);
+}
+
+static GType
+zanata_project_catalog_get_item_type (GListModel *list)
+{
+  return ZANATA_TYPE_PROJECT;
+}
+
+static guint
+zanata_project_catalog_get_n_items (GListModel *list)
+{
+  ZanataProjectCatalog *self = ZANATA_PROJECT_CATALOG (list);
+
+  return self->ids->len;
+}
+
+static gpointer
+zanata_project_catalog_get_item (GListModel *list,
+                                 guint       position)
+{
+  ZanataProjectCatalog *self = ZANATA_PROJECT_CATALOG (list);
+
+  if (position >= self->ids->len)
+    return NULL;
+
+  return zanata_project_catalog_get_project (self, position);
+}
+
+static void
+zanata_project_catalog_list_model_init (GListModelInterface *iface)
+{
+  iface->get_item_type = zanata_project_catalog_get_item_type;
+  iface->get_n_items = zanata_project_catalog_get_n_items;
+  iface->get_item = zanata_project_catalog_get_item;
+}
+
+ZanataProjectCatalog *
+_zanata_project_catalog_new (ZanataSession *session)
+{
+  ZanataProjectCatalog *catalog;
+
+  catalog = g_object_new (ZANATA_TYPE_PROJECT_CATALOG, NULL);
+  catalog->session = g_object_ref (session);
+  catalog->arena = g_byte_array_new ();
+  return catalog;
+}
+
+static guint32
+arena_add (GByteArray  *arena,
+           const gchar *string)
+{
+  guint32 offset = arena->len;
+
+  g_byte_array_append (arena, (const guint8 *) string, strlen (string) + 1);
+  return offset;
+}
+
+static void
+catalog_append (ZanataProjectCatalog *catalog,
+                const gchar          *id,
+                const gchar          *name,
+                ZanataProjectStatus   status)
+{
+  guint32 offset;
+  guint8 status_value = status;
+
+  offset = arena_add (catalog->arena, id);
+  g_array_append_val (catalog->ids, offset);
+  offset = arena_add (catalog->arena, name);
+  g_array_append_val (catalog->names, offset);
+  g_array_append_val (catalog->statuses, status_value);
+}
+
+/* Builds a catalog from a model of already decoded projects, which
+   are kept as the materialized projects of the catalog.  */
+ZanataProjectCatalog *
+_zanata_project_catalog_new_from_model (ZanataSession *session,
+                                        GListModel    *projects)
+{
+  ZanataProjectCatalog *catalog;
+  guint i, n_items;
+
+  catalog = _zanata_project_catalog_new (session);
+  n_items = g_list_model_get_n_items (projects);
+  for (i = 0; i < n_items; i++)
+    {
+      ZanataProject *project = g_list_model_get_item (projects, i);
+      gchar *id, *name;
+      ZanataProjectStatus status;
+
+      g_object_get (project,
+                    "id", &id,
+                    "name", &name,
+                    "status", &status,
+                    NULL);
+      catalog_append (catalog, id, name, status);
+      g_hash_table_insert (catalog->projects, GUINT_TO_POINTER (i), project);
+      g_free (id);
+      g_free (name);
+    }
+
+  return catalog;
+}
+
+static inline const gchar *
+arena_get (GByteArray *arena,
+           GArray     *column,
+           guint       position)
+{
+  return (const gchar *) arena->data + g_array_index (column, guint32,
+                                                      position);
+}
+
+/**
+ * zanata_project_catalog_get_id:
+ * @catalog: a #ZanataProjectCatalog
+ * @position: the position of a project
+ *
+ * Returns the id of the project at @position, without creating a
+ * #ZanataProject.
+ *
+ * Returns: the project id
+ */
+const gchar *
+zanata_project_catalog_get_id (ZanataProjectCatalog *catalog,
+                               guint                 position)
+{
+  g_return_val_if_fail (ZANATA_IS_PROJECT_CATALOG (catalog), NULL);
+  g_return_val_if_fail (position < catalog->ids->len, NULL);
+
+  return arena_get (catalog->arena, catalog->ids, position);
+}
+
+/**
+ * zanata_project_catalog_get_name:
+ * @catalog: a #ZanataProjectCatalog
+ * @position: the position of a project
+ *
+ * Returns the name of the project at @position, without creating a
+ * #ZanataProject.
+ *
+ * Returns: the project name
+ */
+const gchar *
+zanata_project_catalog_get_name (ZanataProjectCatalog *catalog,
+                                 guint                 position)
+{
+  g_return_val_if_fail (ZANATA_IS_PROJECT_CATALOG (catalog), NULL);
+  g_return_val_if_fail (position < catalog->names->len, NULL);
+
+  return arena_get (catalog->arena, catalog->names, position);
+}
+
+/**
+ * zanata_project_catalog_get_status:
+ * @catalog: a #ZanataProjectCatalog
+ * @position: the position of a project
+ *
+ * Returns the status of the project at @position, without creating a
+ * #ZanataProject.
+ *
+ * Returns: a #ZanataProjectStatus
+ */
+ZanataProjectStatus
+zanata_project_catalog_get_status (ZanataProjectCatalog *catalog,
+                                   guint                 position)
+{
+  g_return_val_if_fail (ZANATA_IS_PROJECT_CATALOG (catalog),
+                        ZANATA_PROJECT_STATUS_UNKNOWN);
+  g_return_val_if_fail (position < catalog->statuses->len,
+                        ZANATA_PROJECT_STATUS_UNKNOWN);
+
+  return g_array_index (catalog->statuses, guint8, position);
+}
+
+/**
+ * zanata_project_catalog_get_project:
+ * @catalog: a #ZanataProjectCatalog
+ * @position: the position of a project
+ *
+ * Returns the project at @position.  The #ZanataProject is created on
+ * the first call and the same object is returned afterwards.
+ *
+ * Returns: (transfer full): a #ZanataProject
+ */
+ZanataProject *
+zanata_project_catalog_get_project (ZanataProjectCatalog *catalog,
+                                    guint                 position)
+{
+  ZanataProject *project;
+
+  g_return_val_if_fail (ZANATA_IS_PROJECT_CATALOG (catalog), NULL);
+  g_return_val_if_fail (position < catalog->ids->len, NULL);
+
+  g_mutex_lock (&catalog->projects_lock);
+  project = g_hash_table_lookup (catalog->projects,
+                                 GUINT_TO_POINTER (position));
+  if (project == NULL)
+    {
+      project =
+        g_object_new (ZANATA_TYPE_PROJECT,
+                      "session", catalog->session,
+                      "id", arena_get (catalog->arena, catalog->ids,
+                                       position),
+                      "name", arena_get (catalog->arena, catalog->names,
+                                         position),
+                      "status", g_array_index (catalog->statuses, guint8,
+                                               position),
+                      "loaded", FALSE,
+                      NULL);
+      g_hash_table_insert (catalog->projects,
+                           GUINT_TO_POINTER (position), project);
+    }
+  g_object_ref (project);
+  g_mutex_unlock (&catalog->projects_lock);
+
+  return project;
+}
+
+/**
+ * zanata_project_catalog_lookup:
+ * @catalog: a #ZanataProjectCatalog
+ * @id: a project id
+ * @position: (out) (optional): return location for the position
+ *
+ * Looks up the project whose id is @id.
+ *
+ * Returns: %TRUE if the project was found
+ */
+gboolean
+zanata_project_catalog_lookup (ZanataProjectCatalog *catalog,
+                               const gchar          *id,
+                               guint                *position)
+{
+  guint i;
+
+  g_return_val_if_fail (ZANATA_IS_PROJECT_CATALOG (catalog), FALSE);
+  g_return_val_if_fail (id != NULL, FALSE);
+
+  for (i = 0; i < catalog->ids->len; i++)
+    if (strcmp (arena_get (catalog->arena, catalog->ids, i), id) == 0)
+      {
+        if (position)
+          *position = i;
+        return TRUE;
+      }
+  return FALSE;
+}
+
+/**
+ * zanata_project_catalog_filter:
+ * @catalog: a #ZanataProjectCatalog
+ * @func: (scope call): a #ZanataProjectCatalogFilterFunc
+ * @user_data: (closure): user data passed to @func
+ *
+ * Creates a catalog holding the projects of @catalog for which @func
+ * returns %TRUE, in the same order.  The strings are shared with
+ * @catalog rather than copied.
+ *
+ * Returns: (transfer full): a new #ZanataProjectCatalog
+ */
+ZanataProjectCatalog *
+zanata_project_catalog_filter (ZanataProjectCatalog           *catalog,
+                               ZanataProjectCatalogFilterFunc  func,
+                               gpointer                        user_data)
+{
+  ZanataProjectCatalog *filtered;
+  guint i;
+
+  g_return_val_if_fail (ZANATA_IS_PROJECT_CATALOG (catalog), NULL);
+  g_return_val_if_fail (func != NULL, NULL);
+
+  filtered = g_object_new (ZANATA_TYPE_PROJECT_CATALOG, NULL);
+  filtered->session = g_object_ref (catalog->session);
+  filtered->arena = g_byte_array_ref (catalog->arena);
+
+  for (i = 0; i < catalog->ids->len; i++)
+    if (func (catalog, i, user_data))
+      {
+        g_array_append_val (filtered->ids,
+                            g_array_index (catalog->ids, guint32, i));
+        g_array_append_val (filtered->names,
+                            g_array_index (catalog->names, guint32, i));
+        g_array_append_val (filtered->statuses,
+                            g_array_index (catalog->statuses, guint8, i));
+      }
+
+  return filtered;
+}
+
+static void
+catalog_add_node (ZanataProjectCatalog *catalog,
+                  JsonNode             *node)
+{
+  JsonObject *object;
+  const gchar *id, *name, *status;
+
+  if (json_node_get_node_type (node) != JSON_NODE_OBJECT)
+    return;
+
+  object = json_node_get_object (node);
+  id = json_object_get_string_member (object, "id");
+  if (!id)
+    return;
+
+  name = json_object_get_string_member (object, "name");
+  if (!name)
+    return;
+
+  status = json_object_get_string_member (object, "status");
+  if (!status)
+    return;
+
+  catalog_append (catalog, id, name,
+                  _zanata_project_status_from_nick
+                  (status, ZANATA_PROJECT_STATUS_UNKNOWN));
+}
+
+static gboolean
+load_take_node (const gchar *member,
+                JsonNode    *node,
+                gpointer     user_data)
+{
+  catalog_add_node (user_data, node);
+  return FALSE;
+}
+
+static void
+load_read_cb (GObject      *source_object,
+              GAsyncResult *res,
+              gpointer      user_data)
+{
+  GTask *task = G_TASK (user_data);
+  ZanataProjectCatalog *catalog = g_task_get_source_object (task);
+  GError *error = NULL;
+  gboolean loaded;
+
+  loaded = _zanata_json_stream_read_finish (catalog->json, res, &error);
+  g_clear_pointer (&catalog->json, _zanata_json_stream_free);
+  if (loaded)
+    g_task_return_boolean (task, TRUE);
+  else
+    g_task_return_error (task, error);
+  g_object_unref (task);
+}
+
+/* Decodes the project catalog from INPUT into CATALOG, which must be
+   empty.  */
+void
+_zanata_project_catalog_load_async (ZanataProjectCatalog *catalog,
+                                    GInputStream         *input,
+                                    GCancellable         *cancellable,
+                                    GAsyncReadyCallback   callback,
+                                    gpointer              user_data)
+{
+  GTask *task;
+
+  g_return_if_fail (catalog->json == NULL);
+
+  task = g_task_new (catalog, cancellable, callback, user_data);
+  catalog->json = _zanata_json_stream_new (input, NULL);
+
+  /* No value is counted, so the whole document is read.  */
+  _zanata_json_stream_read_async (catalog->json,
+                                  G_MAXUINT,
+                                  load_take_node,
+                                  catalog,
+                                  cancellable,
+                                  load_read_cb,
+                                  task);
+}
+
+gboolean
+_zanata_project_catalog_load_finish (ZanataProjectCatalog  *catalog,
+                                     GAsyncResult          *result,
+                                     GError               **error)
+{
+  g_return_val_if_fail (g_task_is_valid (result, catalog), FALSE);
+
+  return g_task_propagate_boolean (G_TASK (result), error);
+}
@@ -0,0 +1,67 @@
+#ifndef ZANATA_PROJECT_CATALOG_H
+#define ZANATA_PROJECT_CATALOG_H
+
+#include <gio/gio.h>
+#include "zanata-enums.h"
+#include "zanata-project.h"
+
+G_BEGIN_DECLS
+
+#define ZANATA_TYPE_PROJECT_CATALOG (zanata_project_catalog_get_type ())
+
+G_DECLARE_FINAL_TYPE (ZanataProjectCatalog, zanata_project_catalog,
+                      ZANATA, PROJECT_CATALOG, GObject)
+
+/**
+ * ZanataProjectCatalogFilterFunc:
+ * @catalog: a #ZanataProjectCatalog
+ * @position: the position of a project in @catalog
+ * @user_data: user data passed to zanata_project_catalog_filter()
+ *
+ * Decides whether the project at @position is kept by
+ * zanata_project_catalog_filter().
+ *
+ * Returns: %TRUE to keep the project
+ */
+typedef gboolean (*ZanataProjectCatalogFilterFunc)
+                                       (ZanataProjectCatalog *catalog,
+                                        guint                 position,
+                                        gpointer              user_data);
+
+const gchar         *zanata_project_catalog_get_id
+                                       (ZanataProjectCatalog *catalog,
+                                        guint                 position);
+const gchar         *zanata_project_catalog_get_name
+                                       (ZanataProjectCatalog *catalog,
+                                        guint                 position);
+ZanataProjectStatus  zanata_project_catalog_get_status
+                                       (ZanataProjectCatalog *catalog,
+                                        guint                 position);
+ZanataProject       *zanata_project_catalog_get_project
+                                       (ZanataProjectCatalog *catalog,
+                                        guint                 position);
+gboolean             zanata_project_catalog_lookup
+                                       (ZanataProjectCatalog *catalog,
+                                        const gchar          *id,
+                                        guint                *position);
+ZanataProjectCatalog *
+                     zanata_project_catalog_filter
+                                       (ZanataProjectCatalog *catalog,
+                                        ZanataProjectCatalogFilterFunc
+                                                              func,
+                                        gpointer              user_data);
+
+void                 _zanata_project_catalog_load_async
+                                       (ZanataProjectCatalog *catalog,
+                                        GInputStream         *input,
+                                        GCancellable         *cancellable,
+                                        GAsyncReadyCallback   callback,
+                                        gpointer              user_data);
+gboolean             _zanata_project_catalog_load_finish
+                                       (ZanataProjectCatalog *catalog,
+                                        GAsyncResult         *result,
+                                        GError              **error);
+
+G_END_DECLS
+
+#endif  /* ZANATA_PROJECT_CATALOG_H */
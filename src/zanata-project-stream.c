@@ -0,0 +1,275 @@
+#include "config.h"
+
+#include "zanata-project-stream.h"
+#include "zanata-json-stream.h"
+#include "zanata-array-model.h"
+#include "zanata-session.h"
+#include "zanata-enumtypes.h"
+#include "zanata-enumdecode.h"
+
+struct _ZanataProjectStream
+{
+  GObject parent_object;
+  ZanataSession *session;
+  ZanataJsonStream *json;
+};
+
+G_DEFINE_TYPE (ZanataProjectStream, zanata_project_stream, G_TYPE_OBJECT)
+
+enum {
+  PROJECT_RECEIVED,
+  LAST_SIGNAL
+};
+
+static guint project_stream_signals[LAST_SIGNAL] = { 0 };
+
+static void
+zanata_project_stream_dispose (GObject *object)
+{
+  ZanataProjectStream *self = ZANATA_PROJECT_STREAM (object);
+
+  g_clear_object (&self->session);
+
+  G_OBJECT_CLASS (zanata_project_stream_parent_class)->dispose (object);
+}
+
+static void
+zanata_project_stream_finalize (GObject *object)
+{
+  ZanataProjectStream *self = ZANATA_PROJECT_STREAM (object);
+
+  g_clear_pointer (&self->json, _zanata_json_stream_free);
+
+  G_OBJECT_CLASS (zanata_project_stream_parent_class)->finalize (object);
+}
+
+static void
+zanata_project_stream_class_init (ZanataProjectStreamClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->dispose = zanata_project_stream_dispose;
+  object_class->finalize = zanata_project_stream_finalize;
+
+  /**
+   * ZanataProjectStream::project-received:
+   * @stream: a #ZanataProjectStream
+   * @project: a #ZanataProject
+   *
+   * Emitted for each project as soon as it is decoded.
+   */
+  project_stream_signals[PROJECT_RECEIVED] =
+    g_signal_new ("project-received",
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST,
+                  0,
+                  NULL, NULL,
+                  NULL,
+                  G_TYPE_NONE, 1,
+                  ZANATA_TYPE_PROJECT);
+}
+
+static void
+zanata_project_stream_init (ZanataProjectStream *self)
+{
+}
+
+ZanataProjectStream *
+_zanata_project_stream_new (ZanataSession *session,
+                            GInputStream  *input)
+{
+  ZanataProjectStream *stream;
+
+  stream = g_object_new (ZANATA_TYPE_PROJECT_STREAM, NULL);
+  stream->session = g_object_ref (session);
+  stream->json = _zanata_json_stream_new (input, NULL);
+  return stream;
+}
+
+static ZanataProject *
+project_from_node (ZanataProjectStream *stream,
+                   JsonNode            *node)
+{
+  JsonObject *object;
+  const gchar *id, *name, *status;
+  ZanataProject *project;
+
+  if (json_node_get_node_type (node) != JSON_NODE_OBJECT)
+    return NULL;
+
+  object = json_node_get_object (node);
+  id = json_object_get_string_member (object, "id");
+  if (!id)
+    return NULL;
+
+  name = json_object_get_string_member (object, "name");
+  if (!name)
+    return NULL;
+
+  status = json_object_get_string_member (object, "status");
+  if (!status)
+    return NULL;
+
+  project = g_object_new (ZANATA_TYPE_PROJECT,
+                          "session", stream->session,
+                          "id", id,
+                          "name", name,
+                          "status",
+                          _zanata_project_status_from_nick
+                          (status, ZANATA_PROJECT_STATUS_UNKNOWN),
+                          "loaded", FALSE,
+                          NULL);
+  return project;
+}
+
+typedef struct _NextData NextData;
+
+struct _NextData
+{
+  ZanataProjectStream *stream;
+  GPtrArray *projects;
+};
+
+static void
+next_data_free (NextData *data)
+{
+  g_clear_pointer (&data->projects, g_ptr_array_unref);
+  g_slice_free (NextData, data);
+}
+
+static gboolean
+next_take_node (const gchar *member,
+                JsonNode    *node,
+                gpointer     user_data)
+{
+  NextData *data = user_data;
+  ZanataProject *project;
+
+  project = project_from_node (data->stream, node);
+  if (!project)
+    return FALSE;
+
+  g_ptr_array_add (data->projects, project);
+  g_signal_emit (data->stream, project_stream_signals[PROJECT_RECEIVED], 0,
+                 project);
+  return TRUE;
+}
+
+static void
+next_read_cb (GObject      *source_object,
+              GAsyncResult *res,
+              gpointer      user_data)
+{
+  GTask *task = G_TASK (user_data);
+  ZanataProjectStream *stream = g_task_get_source_object (task);
+  NextData *data = g_task_get_task_data (task);
+  GError *error = NULL;
+  ZanataArrayModel *model;
+
+  if (!_zanata_json_stream_read_finish (stream->json, res, &error))
+    {
+      g_task_return_error (task, error);
+      g_object_unref (task);
+      return;
+    }
+
+  model = _zanata_array_model_new_take (ZANATA_TYPE_PROJECT, data->projects);
+  data->projects = NULL;
+  g_task_return_pointer (task, model, g_object_unref);
+  g_object_unref (task);
+}
+
+/**
+ * zanata_project_stream_next_async:
+ * @stream: a #ZanataProjectStream
+ * @max_projects: the maximum number of projects to return
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: a #GAsyncReadyCallback
+ * @user_data: (nullable): a user data
+ *
+ * Starts reading up to @max_projects projects from @stream.  Projects
+ * are decoded as the response is downloaded, so that the whole catalog
+ * never has to be held in memory at once.  This operation is
+ * asynchronous and shall be finished with
+ * zanata_project_stream_next_finish().
+ */
+void
+zanata_project_stream_next_async (ZanataProjectStream *stream,
+                                  guint                max_projects,
+                                  GCancellable        *cancellable,
+                                  GAsyncReadyCallback  callback,
+                                  gpointer             user_data)
+{
+  GTask *task;
+  NextData *data;
+
+  g_return_if_fail (ZANATA_IS_PROJECT_STREAM (stream));
+  g_return_if_fail (max_projects > 0);
+
+  task = g_task_new (stream, cancellable, callback, user_data);
+
+  data = g_slice_new0 (NextData);
+  data->stream = stream;
+  data->projects = g_ptr_array_new_with_free_func (g_object_unref);
+  g_task_set_task_data (task, data, (GDestroyNotify) next_data_free);
+
+  _zanata_json_stream_read_async (stream->json,
+                                  max_projects,
+                                  next_take_node,
+                                  data,
+                                  cancellable,
+                                  next_read_cb,
+                                  task);
+}
+
+/**
+ * zanata_project_stream_next_finish:
+ * @stream: a #ZanataProjectStream
+ * @result: a #GAsyncResult
+ * @error: error location
+ *
+ * Finishes zanata_project_stream_next_async() operation.  An empty
+ * list returned without an error means that the end of the stream has
+ * been reached.
+ *
+ * Returns: (transfer full) (element-type ZanataProject): a list of
+ * #ZanataProject
+ */
+GList *
+zanata_project_stream_next_finish (ZanataProjectStream  *stream,
+                                   GAsyncResult         *result,
+                                   GError              **error)
+{
+  GListModel *model;
+  GList *projects;
+
+  model = zanata_project_stream_next_finish_model (stream, result, error);
+  if (!model)
+    return NULL;
+
+  projects = _zanata_array_model_to_list (ZANATA_ARRAY_MODEL (model));
+  g_object_unref (model);
+  return projects;
+}
+
+/**
+ * zanata_project_stream_next_finish_model:
+ * @stream: a #ZanataProjectStream
+ * @result: a #GAsyncResult
+ * @error: error location
+ *
+ * Finishes zanata_project_stream_next_async() operation, like
+ * zanata_project_stream_next_finish(), but returns the projects as a
+ * #GListModel.
+ *
+ * Returns: (transfer full): a #GListModel of #ZanataProject
+ */
+GListModel *
+zanata_project_stream_next_finish_model (ZanataProjectStream  *stream,
+                                         GAsyncResult         *result,
+                                         GError              **error)
+{
+  g_return_val_if_fail (g_task_is_valid (result, stream), NULL);
+
+  return g_task_propagate_pointer (G_TASK (result), error);
+}
@@ -0,0 +1,29 @@
+#ifndef ZANATA_PROJECT_STREAM_H
+#define ZANATA_PROJECT_STREAM_H
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+#define ZANATA_TYPE_PROJECT_STREAM (zanata_project_stream_get_type ())
+
+G_DECLARE_FINAL_TYPE (ZanataProjectStream, zanata_project_stream,
+                      ZANATA, PROJECT_STREAM, GObject)
+
+void   zanata_project_stream_next_async  (ZanataProjectStream *stream,
+                                          guint                max_projects,
+                                          GCancellable        *cancellable,
+                                          GAsyncReadyCallback  callback,
+                                          gpointer             user_data);
+GList *zanata_project_stream_next_finish (ZanataProjectStream *stream,
+                                          GAsyncResult        *result,
+                                          GError             **error);
+GListModel *
+       zanata_project_stream_next_finish_model
+                                         (ZanataProjectStream *stream,
+                                          GAsyncResult        *result,
+                                          GError             **error);
+
+G_END_DECLS
+
+#endif  /* ZANATA_PROJECT_STREAM_H */
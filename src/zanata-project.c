@@ -3,6 +3,7 @@
 #include "zanata-project.h"
 #include "zanata-session.h"
 #include "zanata-enumtypes.h"
+#include "zanata-array-model.h"
 
 struct _ZanataProject
 {
@@ -12,7 +13,7 @@ struct _ZanataProject
   gchar *name;
   gchar *description;
   ZanataProjectStatus status;
-  GList *iterations;
+  GPtrArray *iterations;
   gboolean loaded;
   GMutex lock;
 };
@@ -124,7 +125,7 @@ zanata_project_finalize (GObject *object)
   ZanataProject *self = ZANATA_PROJECT (object);
 
   g_mutex_clear (&self->lock);
-  g_list_free_full (self->iterations, g_object_unref);
+  g_clear_pointer (&self->iterations, g_ptr_array_unref);
   g_free (self->id);
   g_free (self->name);
   g_free (self->description);
@@ -187,15 +188,7 @@ static void
 zanata_project_init (ZanataProject *self)
 {
   g_mutex_init (&self->lock);
-}
-
-static void
-collect_iterations (gpointer data,
-                    gpointer user_data)
-{
-  ZanataIteration *iteration = data;
-  GList **iterations = user_data;
-  *iterations = g_list_append (*iterations, g_object_ref (iteration));
+  self->iterations = g_ptr_array_new_with_free_func (g_object_unref);
 }
 
 static void
@@ -212,16 +205,22 @@ get_project_cb (GObject      *source_object,
   loaded = zanata_session_get_project_finish (session, res, &error);
   if (!loaded)
     {
-      g_mutex_unlock (&project->lock);
       g_task_return_error (task, error);
       g_object_unref (task);
       return;
     }
 
-  project->iterations = NULL;
-  g_list_foreach (loaded->iterations, collect_iterations, &project->iterations);
-  g_object_unref (loaded);
+  /* The array is shared with models handed out earlier, so replace it
+     rather than modifying it in place.  */
+  g_mutex_lock (&project->lock);
+  if (!project->loaded)
+    {
+      g_ptr_array_unref (project->iterations);
+      project->iterations = g_ptr_array_ref (loaded->iterations);
+      project->loaded = TRUE;
+    }
   g_mutex_unlock (&project->lock);
+  g_object_unref (loaded);
 
   g_task_return_boolean (task, TRUE);
   g_object_unref (task);
@@ -234,11 +233,17 @@ zanata_project_get_iterations (ZanataProject       *project,
                                gpointer             user_data)
 {
   GTask *task;
+  gboolean loaded;
 
   task = g_task_new (project, cancellable, callback, user_data);
 
+  /* The lock only protects the fields; concurrent loads of the same
+     project are merged by the session.  */
   g_mutex_lock (&project->lock);
-  if (!project->loaded)
+  loaded = project->loaded;
+  g_mutex_unlock (&project->lock);
+
+  if (!loaded)
     {
       zanata_session_get_project (project->session,
                                   project->id,
@@ -248,7 +253,6 @@ zanata_project_get_iterations (ZanataProject       *project,
     }
   else
     {
-      g_mutex_unlock (&project->lock);
       g_task_return_boolean (task, TRUE);
       g_object_unref (task);
     }
@@ -270,17 +274,54 @@ zanata_project_get_iterations_finish (ZanataProject  *project,
                                       GAsyncResult   *result,
                                       GError        **error)
 {
+  GListModel *model;
+  GList *iterations;
+
+  model = zanata_project_get_iterations_finish_model (project, result, error);
+  if (!model)
+    return NULL;
+
+  iterations = _zanata_array_model_to_list (ZANATA_ARRAY_MODEL (model));
+  g_object_unref (model);
+  return iterations;
+}
+
+/**
+ * zanata_project_get_iterations_finish_model:
+ * @project: a #ZanataProject
+ * @result: a #GAsyncResult
+ * @error: a #GError
+ *
+ * Finishes zanata_project_get_iterations() operation, like
+ * zanata_project_get_iterations_finish(), but returns the iterations
+ * as a #GListModel.
+ *
+ * Returns: (transfer full): a #GListModel of #ZanataIteration
+ */
+GListModel *
+zanata_project_get_iterations_finish_model (ZanataProject  *project,
+                                            GAsyncResult   *result,
+                                            GError        **error)
+{
+  GListModel *model = NULL;
+
   g_return_val_if_fail (g_task_is_valid (result, project), NULL);
 
   if (g_task_propagate_boolean (G_TASK (result), error))
-    return project->iterations;
+    {
+      g_mutex_lock (&project->lock);
+      model =
+        G_LIST_MODEL (_zanata_array_model_new_take (ZANATA_TYPE_ITERATION,
+                                                    g_ptr_array_ref (project->iterations)));
+      g_mutex_unlock (&project->lock);
+    }
 
-  return NULL;
+  return model;
 }
 
 void
 _zanata_project_add_iteration (ZanataProject   *project,
                                ZanataIteration *iteration)
 {
-  project->iterations = g_list_append (project->iterations, iteration);
+  g_ptr_array_add (project->iterations, iteration);
 }
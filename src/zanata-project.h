@@ -19,6 +19,11 @@ void   _zanata_project_add_iteration        (ZanataProject       *project,
 GList *zanata_project_get_iterations_finish (ZanataProject       *project,
                                              GAsyncResult        *result,
                                              GError             **error);
+GListModel *
+       zanata_project_get_iterations_finish_model
+                                            (ZanataProject       *project,
+                                             GAsyncResult        *result,
+                                             GError             **error);
 
 G_END_DECLS
 
@@ -0,0 +1,217 @@
+#include "config.h"
+
+#include "zanata-rate-limiter.h"
+
+typedef struct _Bucket Bucket;
+
+struct _Bucket
+{
+  gchar *domain;
+
+  /* The limiters attached to this bucket.  */
+  GPtrArray *limiters;
+
+  /* Tokens per second, or 0 for no limit, merged from the limiters.  */
+  gdouble rate;
+  gdouble burst;
+
+  /* May go negative: each reservation takes a token right away and
+     waits for the debt to be refilled, which keeps waiters in FIFO
+     order without re-checking.  */
+  gdouble tokens;
+  gint64 updated;
+
+  /* Set from a Retry-After header.  */
+  gint64 blocked_until;
+};
+
+struct _ZanataRateLimiter
+{
+  Bucket *bucket;
+
+  /* The limit requested by the owner of this limiter, 0 for none.  */
+  gdouble rate;
+  guint burst;
+};
+
+G_LOCK_DEFINE_STATIC (buckets);
+static GHashTable *buckets;
+
+static void
+bucket_free (Bucket *bucket)
+{
+  g_free (bucket->domain);
+  g_ptr_array_unref (bucket->limiters);
+  g_slice_free (Bucket, bucket);
+}
+
+/* Must be called with the lock held.  */
+static void
+refill (Bucket *bucket,
+        gint64  now)
+{
+  if (bucket->rate > 0)
+    {
+      bucket->tokens += bucket->rate * (now - bucket->updated) / G_USEC_PER_SEC;
+      bucket->tokens = MIN (bucket->tokens, bucket->burst);
+    }
+  bucket->updated = now;
+}
+
+/* Recomputes the limit of BUCKET as the strictest of the limits of its
+   limiters.  Must be called with the lock held.  */
+static void
+merge_limits (Bucket *bucket)
+{
+  gdouble rate = 0;
+  guint burst = G_MAXUINT;
+  guint i;
+
+  refill (bucket, g_get_monotonic_time ());
+
+  for (i = 0; i < bucket->limiters->len; i++)
+    {
+      ZanataRateLimiter *limiter = g_ptr_array_index (bucket->limiters, i);
+
+      if (limiter->rate <= 0)
+        continue;
+      if (rate == 0 || limiter->rate < rate)
+        rate = limiter->rate;
+      burst = MIN (burst, MAX (limiter->burst, 1));
+    }
+
+  if (rate == 0)
+    {
+      bucket->rate = 0;
+      return;
+    }
+
+  if (bucket->rate == 0)
+    bucket->tokens = burst;
+  bucket->rate = rate;
+  bucket->burst = burst;
+  bucket->tokens = MIN (bucket->tokens, bucket->burst);
+}
+
+ZanataRateLimiter *
+_zanata_rate_limiter_new (const gchar *domain)
+{
+  ZanataRateLimiter *limiter;
+  Bucket *bucket;
+
+  if (domain == NULL)
+    domain = "";
+
+  G_LOCK (buckets);
+  if (buckets == NULL)
+    buckets = g_hash_table_new_full (g_str_hash, g_str_equal, NULL,
+                                     (GDestroyNotify) bucket_free);
+
+  bucket = g_hash_table_lookup (buckets, domain);
+  if (bucket == NULL)
+    {
+      bucket = g_slice_new0 (Bucket);
+      bucket->domain = g_strdup (domain);
+      bucket->limiters = g_ptr_array_new ();
+      bucket->updated = g_get_monotonic_time ();
+      g_hash_table_insert (buckets, bucket->domain, bucket);
+    }
+
+  limiter = g_slice_new0 (ZanataRateLimiter);
+  limiter->bucket = bucket;
+  g_ptr_array_add (bucket->limiters, limiter);
+  G_UNLOCK (buckets);
+
+  return limiter;
+}
+
+/* Detaches LIMITER from its bucket, lifting its limit.  The bucket is
+   dropped along with its last limiter.  */
+void
+_zanata_rate_limiter_free (ZanataRateLimiter *limiter)
+{
+  Bucket *bucket = limiter->bucket;
+
+  G_LOCK (buckets);
+  g_ptr_array_remove_fast (bucket->limiters, limiter);
+  if (bucket->limiters->len == 0)
+    {
+      g_hash_table_remove (buckets, bucket->domain);
+      if (g_hash_table_size (buckets) == 0)
+        g_clear_pointer (&buckets, g_hash_table_unref);
+    }
+  else
+    merge_limits (bucket);
+  G_UNLOCK (buckets);
+
+  g_slice_free (ZanataRateLimiter, limiter);
+}
+
+void
+_zanata_rate_limiter_configure (ZanataRateLimiter *limiter,
+                                gdouble            rate,
+                                guint              burst)
+{
+  G_LOCK (buckets);
+  limiter->rate = rate;
+  limiter->burst = burst;
+  merge_limits (limiter->bucket);
+  G_UNLOCK (buckets);
+}
+
+/* Takes a token for a request through LIMITER.  Returns the number of
+   microseconds to wait before sending it.  */
+gint64
+_zanata_rate_limiter_reserve (ZanataRateLimiter *limiter)
+{
+  Bucket *bucket = limiter->bucket;
+  gint64 now, wait = 0;
+
+  now = g_get_monotonic_time ();
+
+  G_LOCK (buckets);
+  if (bucket->rate > 0)
+    {
+      refill (bucket, now);
+      bucket->tokens -= 1;
+      if (bucket->tokens < 0)
+        wait = -bucket->tokens * G_USEC_PER_SEC / bucket->rate;
+    }
+  if (bucket->blocked_until > now)
+    wait = MAX (wait, bucket->blocked_until - now);
+  G_UNLOCK (buckets);
+
+  return wait;
+}
+
+/* Gives back a token taken by _zanata_rate_limiter_reserve(), for a
+   request which was cancelled before it was sent.  */
+void
+_zanata_rate_limiter_release (ZanataRateLimiter *limiter)
+{
+  Bucket *bucket = limiter->bucket;
+
+  G_LOCK (buckets);
+  if (bucket->rate > 0)
+    {
+      refill (bucket, g_get_monotonic_time ());
+      bucket->tokens = MIN (bucket->tokens + 1, bucket->burst);
+    }
+  G_UNLOCK (buckets);
+}
+
+/* Holds back every request to the domain of LIMITER for DELAY
+   microseconds, as asked by the server.  */
+void
+_zanata_rate_limiter_defer (ZanataRateLimiter *limiter,
+                            gint64             delay)
+{
+  Bucket *bucket = limiter->bucket;
+  gint64 until;
+
+  until = g_get_monotonic_time () + delay;
+
+  G_LOCK (buckets);
+  bucket->blocked_until = MAX (bucket->blocked_until, until);
+  G_UNLOCK (buckets);
+}
@@ -0,0 +1,27 @@
+#ifndef ZANATA_RATE_LIMITER_H
+#define ZANATA_RATE_LIMITER_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* Token buckets shared by every session talking to the same
+   authorization domain.  Each session holds a limiter on the bucket of
+   its domain, which lives as long as any limiter does; the bucket
+   enforces the strictest of the limits configured by its limiters.  */
+
+typedef struct _ZanataRateLimiter ZanataRateLimiter;
+
+ZanataRateLimiter *_zanata_rate_limiter_new       (const gchar       *domain);
+void               _zanata_rate_limiter_free      (ZanataRateLimiter *limiter);
+void               _zanata_rate_limiter_configure (ZanataRateLimiter *limiter,
+                                                   gdouble            rate,
+                                                   guint              burst);
+gint64             _zanata_rate_limiter_reserve   (ZanataRateLimiter *limiter);
+void               _zanata_rate_limiter_release   (ZanataRateLimiter *limiter);
+void               _zanata_rate_limiter_defer     (ZanataRateLimiter *limiter,
+                                                   gint64             delay);
+
+G_END_DECLS
+
+#endif  /* ZANATA_RATE_LIMITER_H */
@@ -0,0 +1,904 @@
+#include "config.h"
+
+#include "zanata-request.h"
+#include "zanata-enumtypes.h"
+
+#include <string.h>
+
+struct _ZanataRequest
+{
+  GObject parent_object;
+  gchar *method;
+  SoupURI *endpoint;
+
+  /* Name and value pairs, stored one after another.  */
+  GPtrArray *parameters;
+  GPtrArray *headers;
+
+  gchar *content_type;
+  GBytes *body;
+  gchar *accept;
+
+  /* The gzip-compressed form of BODY, computed on first use.  */
+  GBytes *compressed_body;
+
+  /* A body streamed from BODY_STREAM, starting at BODY_OFFSET if the
+     stream is seekable, with BODY_LENGTH bytes or -1 if unknown.  */
+  GInputStream *body_stream;
+  goffset body_offset;
+  gssize body_length;
+  ZanataRequestPriority priority;
+  gboolean idempotent;
+  gint timeout;
+};
+
+G_DEFINE_TYPE (ZanataRequest, zanata_request, G_TYPE_OBJECT)
+
+enum {
+  PROP_0,
+  PROP_METHOD,
+  PROP_ENDPOINT,
+  PROP_PRIORITY,
+  PROP_IDEMPOTENT,
+  PROP_TIMEOUT,
+  LAST_PROP
+};
+
+static GParamSpec *request_pspecs[LAST_PROP] = { 0 };
+
+static void
+zanata_request_set_property (GObject      *object,
+                             guint         prop_id,
+                             const GValue *value,
+                             GParamSpec   *pspec)
+{
+  ZanataRequest *self = ZANATA_REQUEST (object);
+
+  switch (prop_id)
+    {
+    case PROP_METHOD:
+      self->method = g_value_dup_string (value);
+      break;
+
+    case PROP_ENDPOINT:
+      self->endpoint = g_value_dup_boxed (value);
+      break;
+
+    case PROP_PRIORITY:
+      self->priority = g_value_get_enum (value);
+      break;
+
+    case PROP_IDEMPOTENT:
+      self->idempotent = g_value_get_boolean (value);
+      break;
+
+    case PROP_TIMEOUT:
+      self->timeout = g_value_get_int (value);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+zanata_request_get_property (GObject    *object,
+                             guint       prop_id,
+                             GValue     *value,
+                             GParamSpec *pspec)
+{
+  ZanataRequest *self = ZANATA_REQUEST (object);
+
+  switch (prop_id)
+    {
+    case PROP_METHOD:
+      g_value_set_string (value, self->method);
+      break;
+
+    case PROP_ENDPOINT:
+      g_value_set_boxed (value, self->endpoint);
+      break;
+
+    case PROP_PRIORITY:
+      g_value_set_enum (value, self->priority);
+      break;
+
+    case PROP_IDEMPOTENT:
+      g_value_set_boolean (value, self->idempotent);
+      break;
+
+    case PROP_TIMEOUT:
+      g_value_set_int (value, self->timeout);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+zanata_request_finalize (GObject *object)
+{
+  ZanataRequest *self = ZANATA_REQUEST (object);
+
+  g_free (self->method);
+  g_clear_pointer (&self->endpoint, soup_uri_free);
+  g_ptr_array_unref (self->parameters);
+  g_ptr_array_unref (self->headers);
+  g_free (self->content_type);
+  g_clear_pointer (&self->body, g_bytes_unref);
+  g_clear_pointer (&self->compressed_body, g_bytes_unref);
+  g_clear_object (&self->body_stream);
+  g_free (self->accept);
+
+  G_OBJECT_CLASS (zanata_request_parent_class)->finalize (object);
+}
+
+static void
+zanata_request_class_init (ZanataRequestClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->set_property = zanata_request_set_property;
+  object_class->get_property = zanata_request_get_property;
+  object_class->finalize = zanata_request_finalize;
+
+  request_pspecs[PROP_METHOD] =
+    g_param_spec_string ("method",
+                         "Method",
+                         "The HTTP method",
+                         "GET",
+                         G_PARAM_CONSTRUCT_ONLY | G_PARAM_READWRITE);
+  request_pspecs[PROP_ENDPOINT] =
+    g_param_spec_boxed ("endpoint",
+                        "Endpoint",
+                        "The endpoint URI",
+                        SOUP_TYPE_URI,
+                        G_PARAM_CONSTRUCT_ONLY | G_PARAM_READWRITE);
+  request_pspecs[PROP_PRIORITY] =
+    g_param_spec_enum ("priority",
+                       "Priority",
+                       "The scheduling class of the request",
+                       ZANATA_TYPE_REQUEST_PRIORITY,
+                       ZANATA_REQUEST_PRIORITY_INTERACTIVE,
+                       G_PARAM_READWRITE);
+  request_pspecs[PROP_IDEMPOTENT] =
+    g_param_spec_boolean ("idempotent",
+                          "Idempotent",
+                          "Whether the request can be safely retried regardless of its method",
+                          FALSE,
+                          G_PARAM_READWRITE);
+  request_pspecs[PROP_TIMEOUT] =
+    g_param_spec_int ("timeout",
+                      "Timeout",
+                      "Milliseconds before the request is aborted, 0 for no limit, or -1 for the session default",
+                      -1, G_MAXINT, -1,
+                      G_PARAM_CONSTRUCT | G_PARAM_READWRITE);
+  g_object_class_install_properties (object_class, LAST_PROP,
+                                     request_pspecs);
+}
+
+static void
+zanata_request_init (ZanataRequest *self)
+{
+  self->parameters = g_ptr_array_new_with_free_func (g_free);
+  self->headers = g_ptr_array_new_with_free_func (g_free);
+}
+
+/**
+ * zanata_request_new:
+ * @method: an HTTP method
+ * @endpoint: a #SoupURI
+ *
+ * Creates a new request to @endpoint, which can be sent with
+ * zanata_session_send().
+ *
+ * Returns: (transfer full): a new #ZanataRequest
+ */
+ZanataRequest *
+zanata_request_new (const gchar *method,
+                    SoupURI     *endpoint)
+{
+  return g_object_new (ZANATA_TYPE_REQUEST,
+                       "method", method,
+                       "endpoint", endpoint,
+                       NULL);
+}
+
+/**
+ * zanata_request_get_method:
+ * @request: a #ZanataRequest
+ *
+ * Returns: the HTTP method of @request
+ */
+const gchar *
+zanata_request_get_method (ZanataRequest *request)
+{
+  g_return_val_if_fail (ZANATA_IS_REQUEST (request), NULL);
+  return request->method;
+}
+
+/**
+ * zanata_request_get_endpoint:
+ * @request: a #ZanataRequest
+ *
+ * Returns: (transfer none): the endpoint URI of @request
+ */
+SoupURI *
+zanata_request_get_endpoint (ZanataRequest *request)
+{
+  g_return_val_if_fail (ZANATA_IS_REQUEST (request), NULL);
+  return request->endpoint;
+}
+
+/**
+ * zanata_request_add_parameter:
+ * @request: a #ZanataRequest
+ * @name: a parameter name
+ * @value: a parameter value
+ *
+ * Appends a query parameter to @request.  The same @name may be
+ * given more than once.
+ */
+void
+zanata_request_add_parameter (ZanataRequest *request,
+                              const gchar   *name,
+                              const gchar   *value)
+{
+  g_return_if_fail (ZANATA_IS_REQUEST (request));
+  g_ptr_array_add (request->parameters, g_strdup (name));
+  g_ptr_array_add (request->parameters, g_strdup (value));
+}
+
+/**
+ * zanata_request_add_header:
+ * @request: a #ZanataRequest
+ * @name: a header name
+ * @value: a header value
+ *
+ * Appends a request header to @request.
+ */
+void
+zanata_request_add_header (ZanataRequest *request,
+                           const gchar   *name,
+                           const gchar   *value)
+{
+  g_return_if_fail (ZANATA_IS_REQUEST (request));
+  g_ptr_array_add (request->headers, g_strdup (name));
+  g_ptr_array_add (request->headers, g_strdup (value));
+}
+
+/**
+ * zanata_request_set_body:
+ * @request: a #ZanataRequest
+ * @content_type: (nullable): the content type of @body
+ * @body: (array length=length) (element-type guint8): the request body
+ * @length: the length of @body, or -1 if it is nul-terminated
+ *
+ * Sets the request body of @request.
+ */
+void
+zanata_request_set_body (ZanataRequest *request,
+                         const gchar   *content_type,
+                         const gchar   *body,
+                         gssize         length)
+{
+  g_return_if_fail (ZANATA_IS_REQUEST (request));
+
+  if (length < 0)
+    length = strlen (body);
+
+  g_free (request->content_type);
+  request->content_type = g_strdup (content_type);
+  g_clear_pointer (&request->body, g_bytes_unref);
+  g_clear_pointer (&request->compressed_body, g_bytes_unref);
+  g_clear_object (&request->body_stream);
+  request->body = g_bytes_new (body, length);
+}
+
+/**
+ * zanata_request_set_body_bytes:
+ * @request: a #ZanataRequest
+ * @content_type: (nullable): the content type of @body
+ * @body: a #GBytes
+ *
+ * Sets the request body of @request, like zanata_request_set_body(),
+ * but without copying @body, which is sent as is.
+ */
+void
+zanata_request_set_body_bytes (ZanataRequest *request,
+                               const gchar   *content_type,
+                               GBytes        *body)
+{
+  g_return_if_fail (ZANATA_IS_REQUEST (request));
+  g_return_if_fail (body != NULL);
+
+  g_free (request->content_type);
+  request->content_type = g_strdup (content_type);
+  g_clear_pointer (&request->body, g_bytes_unref);
+  g_clear_pointer (&request->compressed_body, g_bytes_unref);
+  g_clear_object (&request->body_stream);
+  request->body = g_bytes_ref (body);
+}
+
+/**
+ * zanata_request_set_body_stream:
+ * @request: a #ZanataRequest
+ * @content_type: (nullable): the content type of the body
+ * @stream: a #GInputStream
+ * @length: the number of bytes to read from @stream, or -1 to read
+ *   until the end of @stream
+ *
+ * Sets the request body of @request to the contents of @stream, which
+ * are read and uploaded piece by piece, so that the body never has to
+ * be held in memory at once.  If @length is -1, the body is sent with
+ * chunked encoding.
+ *
+ * The request can only be retried, for example after a transient
+ * failure, if @stream is seekable.
+ */
+void
+zanata_request_set_body_stream (ZanataRequest *request,
+                                const gchar   *content_type,
+                                GInputStream  *stream,
+                                gssize         length)
+{
+  g_return_if_fail (ZANATA_IS_REQUEST (request));
+  g_return_if_fail (G_IS_INPUT_STREAM (stream));
+
+  g_free (request->content_type);
+  request->content_type = g_strdup (content_type);
+  g_clear_pointer (&request->body, g_bytes_unref);
+  g_clear_pointer (&request->compressed_body, g_bytes_unref);
+  g_clear_object (&request->body_stream);
+  request->body_stream = g_object_ref (stream);
+  request->body_length = length;
+  request->body_offset = -1;
+  if (G_IS_SEEKABLE (stream) && g_seekable_can_seek (G_SEEKABLE (stream)))
+    request->body_offset = g_seekable_tell (G_SEEKABLE (stream));
+}
+
+/**
+ * zanata_request_set_accept:
+ * @request: a #ZanataRequest
+ * @content_type: (nullable): the expected content type of the response
+ *
+ * Sets the content type that @request accepts as a response.
+ */
+void
+zanata_request_set_accept (ZanataRequest *request,
+                           const gchar   *content_type)
+{
+  g_return_if_fail (ZANATA_IS_REQUEST (request));
+  g_free (request->accept);
+  request->accept = g_strdup (content_type);
+}
+
+/**
+ * zanata_request_get_idempotent:
+ * @request: a #ZanataRequest
+ *
+ * Returns: %TRUE if @request has been marked as idempotent
+ */
+gboolean
+zanata_request_get_idempotent (ZanataRequest *request)
+{
+  g_return_val_if_fail (ZANATA_IS_REQUEST (request), FALSE);
+  return request->idempotent;
+}
+
+/**
+ * zanata_request_set_idempotent:
+ * @request: a #ZanataRequest
+ * @idempotent: whether @request is idempotent
+ *
+ * Marks @request as safe to retry after a transient failure, even if
+ * its method is not idempotent by definition, such as a POST which
+ * only queries the server.
+ */
+void
+zanata_request_set_idempotent (ZanataRequest *request,
+                               gboolean       idempotent)
+{
+  g_return_if_fail (ZANATA_IS_REQUEST (request));
+  request->idempotent = idempotent;
+}
+
+/**
+ * zanata_request_get_priority:
+ * @request: a #ZanataRequest
+ *
+ * Returns: the scheduling class of @request
+ */
+ZanataRequestPriority
+zanata_request_get_priority (ZanataRequest *request)
+{
+  g_return_val_if_fail (ZANATA_IS_REQUEST (request),
+                        ZANATA_REQUEST_PRIORITY_INTERACTIVE);
+  return request->priority;
+}
+
+/**
+ * zanata_request_set_priority:
+ * @request: a #ZanataRequest
+ * @priority: a #ZanataRequestPriority
+ *
+ * Sets the scheduling class of @request.  When the session is at its
+ * per-host limit, queued interactive requests are always sent before
+ * bulk ones.
+ */
+void
+zanata_request_set_priority (ZanataRequest         *request,
+                             ZanataRequestPriority  priority)
+{
+  g_return_if_fail (ZANATA_IS_REQUEST (request));
+  request->priority = priority;
+}
+
+/**
+ * zanata_request_get_timeout:
+ * @request: a #ZanataRequest
+ *
+ * Returns: the deadline of @request in milliseconds, 0 if it has
+ * none, or -1 if it uses the #ZanataSession:timeout of the session
+ */
+gint
+zanata_request_get_timeout (ZanataRequest *request)
+{
+  g_return_val_if_fail (ZANATA_IS_REQUEST (request), -1);
+  return request->timeout;
+}
+
+/**
+ * zanata_request_set_timeout:
+ * @request: a #ZanataRequest
+ * @timeout: milliseconds, 0 for no limit, or -1
+ *
+ * Overrides the #ZanataSession:timeout of the session for @request.
+ * The deadline covers the whole operation, from queueing and retries
+ * to reading the response body; once it passes, the operation fails
+ * with %ZANATA_ERROR_TIMED_OUT.
+ */
+void
+zanata_request_set_timeout (ZanataRequest *request,
+                            gint           timeout)
+{
+  g_return_if_fail (ZANATA_IS_REQUEST (request));
+  g_return_if_fail (timeout >= -1);
+  request->timeout = timeout;
+}
+
+/* Feeds the body of a message from a stream.  libsoup writes the
+   request body from chunks already appended to it, so the next chunk
+   is read as soon as the previous one has been written; written
+   chunks are discarded.  The message is paused while a chunk is being
+   read, so that a slow stream does not block the main context.  */
+
+#define BODY_CHUNK_SIZE (64 * 1024)
+
+static GQuark body_error_quark;
+
+typedef struct _BodyWriter BodyWriter;
+
+struct _BodyWriter
+{
+  GInputStream *stream;
+  goffset offset;
+  gssize length;
+  gsize written;
+
+  /* The session sending the message, to pause it while reading and
+     to abort it on failure.  */
+  SoupSession *session;
+
+  /* Cancels a pending read once the message has finished.  */
+  GCancellable *cancellable;
+  gboolean finished;
+};
+
+static void
+body_writer_free (BodyWriter *writer)
+{
+  g_object_unref (writer->stream);
+  g_object_unref (writer->cancellable);
+  g_slice_free (BodyWriter, writer);
+}
+
+static void
+body_writer_fail (SoupMessage *message,
+                  GError      *error)
+{
+  BodyWriter *writer = g_object_get_data (G_OBJECT (message),
+                                          "zanata-body-writer");
+
+  /* The error is reported instead of the outcome of the message.  */
+  g_object_set_qdata_full (G_OBJECT (message), body_error_quark,
+                           error, (GDestroyNotify) g_error_free);
+  soup_message_body_complete (message->request_body);
+  if (writer->session)
+    soup_session_cancel_message (writer->session, message,
+                                 SOUP_STATUS_IO_ERROR);
+}
+
+static void
+body_writer_read_cb (GObject      *source_object,
+                     GAsyncResult *res,
+                     gpointer      user_data)
+{
+  SoupMessage *message = SOUP_MESSAGE (user_data);
+  BodyWriter *writer = g_object_get_data (G_OBJECT (message),
+                                          "zanata-body-writer");
+  GError *error = NULL;
+  GBytes *bytes;
+  gsize size;
+
+  bytes = g_input_stream_read_bytes_finish (writer->stream, res, &error);
+  if (writer->finished)
+    {
+      /* The message has been cancelled while reading.  */
+      g_clear_error (&error);
+      g_clear_pointer (&bytes, g_bytes_unref);
+      g_object_unref (message);
+      return;
+    }
+
+  if (!bytes)
+    {
+      body_writer_fail (message, error);
+      g_object_unref (message);
+      return;
+    }
+
+  size = g_bytes_get_size (bytes);
+  if (size == 0)
+    {
+      g_bytes_unref (bytes);
+      if (writer->length >= 0)
+        {
+          body_writer_fail (message,
+                            g_error_new (G_IO_ERROR,
+                                         G_IO_ERROR_PARTIAL_INPUT,
+                                         "request body is shorter than %"
+                                         G_GSSIZE_FORMAT " bytes",
+                                         writer->length));
+          g_object_unref (message);
+          return;
+        }
+      soup_message_body_complete (message->request_body);
+    }
+  else
+    {
+      SoupBuffer *buffer;
+      gconstpointer data;
+
+      writer->written += size;
+      data = g_bytes_get_data (bytes, NULL);
+      buffer = soup_buffer_new_with_owner (data, size, bytes,
+                                           (GDestroyNotify) g_bytes_unref);
+      soup_message_body_append_buffer (message->request_body, buffer);
+      soup_buffer_free (buffer);
+    }
+
+  soup_session_unpause_message (writer->session, message);
+  g_object_unref (message);
+}
+
+static void
+body_writer_next_chunk (SoupMessage *message,
+                        gpointer     user_data)
+{
+  BodyWriter *writer = user_data;
+  gsize size = BODY_CHUNK_SIZE;
+
+  if (writer->length >= 0)
+    {
+      if (writer->written == (gsize) writer->length)
+        {
+          soup_message_body_complete (message->request_body);
+          return;
+        }
+      size = MIN (size, (gsize) writer->length - writer->written);
+    }
+
+  if (writer->session == NULL)
+    {
+      body_writer_fail (message,
+                        g_error_new_literal (G_IO_ERROR,
+                                             G_IO_ERROR_NOT_INITIALIZED,
+                                             "request body can only be "
+                                             "streamed through a session"));
+      return;
+    }
+
+  soup_session_pause_message (writer->session, message);
+  g_input_stream_read_bytes_async (writer->stream,
+                                   size,
+                                   G_PRIORITY_DEFAULT,
+                                   writer->cancellable,
+                                   body_writer_read_cb,
+                                   g_object_ref (message));
+}
+
+static void
+body_writer_finished (SoupMessage *message,
+                      gpointer     user_data)
+{
+  BodyWriter *writer = user_data;
+
+  writer->finished = TRUE;
+  g_cancellable_cancel (writer->cancellable);
+}
+
+static void
+body_writer_start (SoupMessage *message,
+                   gpointer     user_data)
+{
+  BodyWriter *writer = user_data;
+  GError *error = NULL;
+
+  /* The message may be sent again, after a redirection.  */
+  writer->written = 0;
+  if (writer->offset >= 0
+      && !g_seekable_seek (G_SEEKABLE (writer->stream), writer->offset,
+                           G_SEEK_SET, NULL, &error))
+    {
+      body_writer_fail (message, error);
+      return;
+    }
+
+  body_writer_next_chunk (message, writer);
+}
+
+static void
+attach_body_stream (ZanataRequest *request,
+                    SoupMessage   *message)
+{
+  BodyWriter *writer;
+
+  if (body_error_quark == 0)
+    body_error_quark = g_quark_from_static_string ("zanata-request-body-error");
+
+  writer = g_slice_new0 (BodyWriter);
+  writer->stream = g_object_ref (request->body_stream);
+  writer->offset = request->body_offset;
+  writer->length = request->body_length;
+  writer->cancellable = g_cancellable_new ();
+
+  soup_message_headers_replace (message->request_headers,
+                                "Content-Type",
+                                request->content_type != NULL
+                                ? request->content_type
+                                : "application/octet-stream");
+  if (writer->length >= 0)
+    soup_message_headers_set_content_length (message->request_headers,
+                                             writer->length);
+  else
+    soup_message_headers_set_encoding (message->request_headers,
+                                       SOUP_ENCODING_CHUNKED);
+  soup_message_body_set_accumulate (message->request_body, FALSE);
+
+  g_signal_connect (message, "wrote-headers",
+                    G_CALLBACK (body_writer_start), writer);
+  g_signal_connect (message, "wrote-chunk",
+                    G_CALLBACK (body_writer_next_chunk), writer);
+  g_signal_connect (message, "finished",
+                    G_CALLBACK (body_writer_finished), writer);
+  g_object_set_data_full (G_OBJECT (message), "zanata-body-writer",
+                          writer, (GDestroyNotify) body_writer_free);
+}
+
+/* Sets the session sending MESSAGE, which is aborted if its streamed
+   body can't be read.  */
+void
+_zanata_request_set_message_session (SoupMessage *message,
+                                     SoupSession *session)
+{
+  BodyWriter *writer = g_object_get_data (G_OBJECT (message),
+                                          "zanata-body-writer");
+
+  if (writer)
+    writer->session = session;
+}
+
+/* Returns: (transfer full) (nullable): the error which occurred while
+   reading the streamed body of MESSAGE.  */
+GError *
+_zanata_request_take_body_error (SoupMessage *message)
+{
+  if (body_error_quark == 0)
+    return NULL;
+
+  return g_object_steal_qdata (G_OBJECT (message), body_error_quark);
+}
+
+SoupMessage *
+_zanata_request_build_message (ZanataRequest *request)
+{
+  SoupMessage *message;
+  SoupURI *uri;
+  guint i;
+
+  uri = soup_uri_copy (request->endpoint);
+  if (request->parameters->len > 0)
+    {
+      GString *query = g_string_new (NULL);
+
+      for (i = 0; i < request->parameters->len; i += 2)
+        {
+          gchar *encoded;
+
+          encoded = soup_form_encode (request->parameters->pdata[i],
+                                      request->parameters->pdata[i + 1],
+                                      NULL);
+          if (query->len > 0)
+            g_string_append_c (query, '&');
+          g_string_append (query, encoded);
+          g_free (encoded);
+        }
+      soup_uri_set_query (uri, query->str);
+      g_string_free (query, TRUE);
+    }
+
+  message = soup_message_new_from_uri (request->method, uri);
+  soup_uri_free (uri);
+
+  for (i = 0; i < request->headers->len; i += 2)
+    soup_message_headers_append (message->request_headers,
+                                 request->headers->pdata[i],
+                                 request->headers->pdata[i + 1]);
+
+  if (request->accept != NULL)
+    soup_message_headers_append (message->request_headers,
+                                 "Accept", request->accept);
+
+  if (request->body != NULL)
+    {
+      gconstpointer data;
+      gsize length;
+
+      SoupBuffer *buffer;
+
+      /* The buffer keeps a reference on the body instead of copying
+         it.  */
+      data = g_bytes_get_data (request->body, &length);
+      buffer = soup_buffer_new_with_owner (data, length,
+                                           g_bytes_ref (request->body),
+                                           (GDestroyNotify) g_bytes_unref);
+      soup_message_headers_replace (message->request_headers,
+                                    "Content-Type",
+                                    request->content_type != NULL
+                                    ? request->content_type
+                                    : "application/octet-stream");
+      soup_message_body_append_buffer (message->request_body, buffer);
+      soup_buffer_free (buffer);
+    }
+  else if (request->body_stream != NULL)
+    attach_body_stream (request, message);
+
+  return message;
+}
+
+static GBytes *
+compress_bytes (GBytes *bytes)
+{
+  GConverter *compressor;
+  GByteArray *output;
+  const guint8 *input;
+  gsize input_size, nread, nwritten, used = 0;
+  GConverterResult result;
+  GError *error = NULL;
+
+  compressor =
+    G_CONVERTER (g_zlib_compressor_new (G_ZLIB_COMPRESSOR_FORMAT_GZIP, -1));
+  input = g_bytes_get_data (bytes, &input_size);
+  output = g_byte_array_sized_new (input_size / 4 + 64);
+  g_byte_array_set_size (output, input_size / 4 + 64);
+
+  do
+    {
+      if (used == output->len)
+        g_byte_array_set_size (output, output->len * 2);
+
+      result = g_converter_convert (compressor,
+                                    input, input_size,
+                                    output->data + used, output->len - used,
+                                    G_CONVERTER_INPUT_AT_END,
+                                    &nread, &nwritten,
+                                    &error);
+      if (result == G_CONVERTER_ERROR)
+        {
+          if (!g_error_matches (error, G_IO_ERROR, G_IO_ERROR_NO_SPACE))
+            {
+              g_error_free (error);
+              g_byte_array_unref (output);
+              g_object_unref (compressor);
+              return NULL;
+            }
+          g_clear_error (&error);
+          g_byte_array_set_size (output, output->len * 2);
+          continue;
+        }
+
+      input += nread;
+      input_size -= nread;
+      used += nwritten;
+    }
+  while (result != G_CONVERTER_FINISHED);
+
+  g_object_unref (compressor);
+  g_byte_array_set_size (output, used);
+  return g_byte_array_free_to_bytes (output);
+}
+
+/* Replaces the body of MESSAGE, built from REQUEST, with its gzip
+   form, if it is held in memory, at least THRESHOLD bytes long and
+   actually shrinks.  Returns the size of the uncompressed body, or 0
+   if the body was left as is.  */
+gsize
+_zanata_request_compress_message (ZanataRequest *request,
+                                  SoupMessage   *message,
+                                  gsize          threshold)
+{
+  SoupBuffer *buffer;
+  gconstpointer data;
+  gsize length;
+
+  if (request->body == NULL || g_bytes_get_size (request->body) < threshold)
+    return 0;
+
+  if (request->compressed_body == NULL)
+    {
+      request->compressed_body = compress_bytes (request->body);
+
+      /* Remember incompressible bodies as themselves.  */
+      if (request->compressed_body == NULL
+          || (g_bytes_get_size (request->compressed_body)
+              >= g_bytes_get_size (request->body)))
+        {
+          g_clear_pointer (&request->compressed_body, g_bytes_unref);
+          request->compressed_body = g_bytes_ref (request->body);
+        }
+    }
+
+  if (request->compressed_body == request->body)
+    return 0;
+
+  data = g_bytes_get_data (request->compressed_body, &length);
+  buffer = soup_buffer_new_with_owner (data, length,
+                                       g_bytes_ref (request->compressed_body),
+                                       (GDestroyNotify) g_bytes_unref);
+  soup_message_body_truncate (message->request_body);
+  soup_message_body_append_buffer (message->request_body, buffer);
+  soup_buffer_free (buffer);
+  soup_message_headers_replace (message->request_headers,
+                                "Content-Encoding", "gzip");
+
+  return g_bytes_get_size (request->body);
+}
+
+gboolean
+_zanata_request_is_idempotent (ZanataRequest *request)
+{
+  static const gchar * const methods[] =
+    { "GET", "HEAD", "PUT", "DELETE", "OPTIONS" };
+  guint i;
+
+  if (request->idempotent)
+    return TRUE;
+
+  for (i = 0; i < G_N_ELEMENTS (methods); i++)
+    if (g_ascii_strcasecmp (request->method, methods[i]) == 0)
+      return TRUE;
+
+  return FALSE;
+}
+
+/* Returns whether REQUEST can be sent again, which is not the case if
+   its body is streamed from a stream which can't be rewound.  */
+gboolean
+_zanata_request_can_replay (ZanataRequest *request)
+{
+  return request->body_stream == NULL || request->body_offset >= 0;
+}
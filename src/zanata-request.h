@@ -0,0 +1,73 @@
+#ifndef ZANATA_REQUEST_H
+#define ZANATA_REQUEST_H
+
+#include <gio/gio.h>
+#include <libsoup/soup.h>
+#include "zanata-enums.h"
+
+G_BEGIN_DECLS
+
+#define ZANATA_TYPE_REQUEST (zanata_request_get_type ())
+
+G_DECLARE_FINAL_TYPE (ZanataRequest, zanata_request,
+                      ZANATA, REQUEST, GObject)
+
+ZanataRequest *zanata_request_new          (const gchar   *method,
+                                            SoupURI       *endpoint);
+const gchar   *zanata_request_get_method   (ZanataRequest *request);
+SoupURI       *zanata_request_get_endpoint (ZanataRequest *request);
+void           zanata_request_add_parameter
+                                           (ZanataRequest *request,
+                                            const gchar   *name,
+                                            const gchar   *value);
+void           zanata_request_add_header   (ZanataRequest *request,
+                                            const gchar   *name,
+                                            const gchar   *value);
+void           zanata_request_set_body     (ZanataRequest *request,
+                                            const gchar   *content_type,
+                                            const gchar   *body,
+                                            gssize         length);
+void           zanata_request_set_body_bytes
+                                           (ZanataRequest *request,
+                                            const gchar   *content_type,
+                                            GBytes        *body);
+void           zanata_request_set_body_stream
+                                           (ZanataRequest *request,
+                                            const gchar   *content_type,
+                                            GInputStream  *stream,
+                                            gssize         length);
+void           zanata_request_set_accept   (ZanataRequest *request,
+                                            const gchar   *content_type);
+gboolean       zanata_request_get_idempotent
+                                           (ZanataRequest *request);
+void           zanata_request_set_idempotent
+                                           (ZanataRequest *request,
+                                            gboolean       idempotent);
+ZanataRequestPriority
+               zanata_request_get_priority (ZanataRequest *request);
+void           zanata_request_set_priority (ZanataRequest *request,
+                                            ZanataRequestPriority
+                                                           priority);
+gint           zanata_request_get_timeout  (ZanataRequest *request);
+void           zanata_request_set_timeout  (ZanataRequest *request,
+                                            gint           timeout);
+
+SoupMessage   *_zanata_request_build_message
+                                           (ZanataRequest *request);
+gboolean       _zanata_request_is_idempotent
+                                           (ZanataRequest *request);
+gboolean       _zanata_request_can_replay
+                                           (ZanataRequest *request);
+void           _zanata_request_set_message_session
+                                           (SoupMessage   *message,
+                                            SoupSession   *session);
+GError        *_zanata_request_take_body_error
+                                           (SoupMessage   *message);
+gsize          _zanata_request_compress_message
+                                           (ZanataRequest *request,
+                                            SoupMessage   *message,
+                                            gsize          threshold);
+
+G_END_DECLS
+
+#endif  /* ZANATA_REQUEST_H */
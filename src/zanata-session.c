@@ -4,11 +4,34 @@
 #include "zanata-suggestion.h"
 #include "zanata-enums.h"
 #include "zanata-enumtypes.h"
+#include "zanata-enumdecode.h"
+#include "zanata-array-model.h"
+#include "zanata-cache.h"
+#include "zanata-cache-converter.h"
+#include "zanata-suggestion-cache.h"
+#include "zanata-suggestion-list.h"
+#include "zanata-rate-limiter.h"
+#include "zanata-endpoint.h"
+#include "zanata-string-pool.h"
+#include "zanata-counting-converter.h"
 
 #include <json-glib/json-glib.h>
-#include <rest/rest-proxy.h>
 #include <string.h>
 
+#define DEFAULT_MAX_CONNECTIONS_PER_HOST 4
+#define DEFAULT_IDLE_TIMEOUT 60
+#define DEFAULT_SUGGESTION_CACHE_SIZE 256
+#define DEFAULT_CACHE_MEMORY_SIZE (32 * 1024 * 1024)
+#define DEFAULT_SUGGESTION_CACHE_TTL 300
+#define DEFAULT_SUGGESTION_BATCH_SIZE 32
+#define DEFAULT_MAX_RETRIES 3
+#define DEFAULT_RETRY_BASE_DELAY 500
+#define DEFAULT_RETRY_MAX_DELAY 30000
+#define DEFAULT_RATE_BURST 10
+#define DEFAULT_DECODE_THREADS 2
+#define DEFAULT_DECODE_THRESHOLD (64 * 1024)
+#define DEFAULT_TIMEOUT 60000
+
 G_DEFINE_QUARK (zanata-error-quark, zanata_error)
 
 struct _ZanataSession
@@ -16,19 +39,169 @@ struct _ZanataSession
   GObject parent_object;
   ZanataAuthorizer *authorizer;
   gchar *domain;
+
+  /* Shared by every request issued through this session, so that
+     connections are kept alive and reused across calls.  */
+  SoupSession *soup_session;
+  guint max_connections_per_host;
+  guint idle_timeout;
+  gboolean keep_alive;
+
+  gboolean cache_enabled;
+  gchar *cache_directory;
+  guint cache_memory_size;
+  ZanataCache *cache;
+
+  ZanataSuggestionCache *suggestion_cache;
+  guint suggestion_cache_size;
+  guint suggestion_cache_ttl;
+
+  /* Suggestion lookups waiting to be sent or in flight, keyed by the
+     same key as the suggestion cache.  */
+  GMutex suggestion_batches_lock;
+  GHashTable *suggestion_batches;
+  guint suggestion_batch_window;
+  guint suggestion_batch_size;
+
+  /* Project loads in flight, mapping a project id to the queue of
+     ProjectWaiter waiting for it.  */
+  GMutex project_loads_lock;
+  GHashTable *project_loads;
+
+  /* Requests waiting for a free slot, per host.  */
+  GMutex scheduler_lock;
+  GHashTable *hosts;
+  guint max_requests_per_host;
+
+  guint max_retries;
+  guint retry_base_delay;
+  guint retry_max_delay;
+
+  gdouble rate_limit;
+  guint rate_burst;
+  ZanataRateLimiter *rate_limiter;
+
+  /* Requests waiting for the authorizer to be refreshed after a 401
+     response.  The generation is bumped after each refresh, so that
+     requests sent with older credentials are replayed without
+     refreshing again.  */
+  GMutex refresh_lock;
+  gboolean refreshing;
+  GQueue refresh_waiters;
+  guint auth_generation;
+
+  /* The URL of the domain, parsed once and dropped whenever the
+     authorizer changes.  The base path has no trailing slash.  */
+  GMutex base_lock;
+  SoupURI *base_uri;
+  gchar *base_path;
+  gulong authorizer_changed_id;
+
+  /* Strings repeated across the objects decoded by this session.  */
+  ZanataStringPool *string_pool;
+
+  /* Workers decoding response bodies larger than the threshold, so
+     that the caller's main context is not blocked.  */
+  GThreadPool *decode_pool;
+  guint decode_threads;
+  guint decode_threshold;
+
+  /* The default deadline of a request, in milliseconds.  */
+  guint timeout;
+
+  /* Request bodies from this size are sent gzip-compressed, if not
+     0.  */
+  guint compress_threshold;
+
+  /* Body bytes sent and received, as they went over the wire and
+     before compression or after decoding respectively.  */
+  GMutex stats_lock;
+  guint64 bytes_sent;
+  guint64 bytes_sent_uncompressed;
+  guint64 bytes_received;
+  guint64 bytes_received_decoded;
 };
 
 G_DEFINE_TYPE (ZanataSession, zanata_session, G_TYPE_OBJECT);
 
+static void decode_job_run (gpointer data,
+                            gpointer user_data);
+
 enum {
   PROP_0,
   PROP_AUTHORIZER,
   PROP_DOMAIN,
+  PROP_MAX_CONNECTIONS_PER_HOST,
+  PROP_IDLE_TIMEOUT,
+  PROP_KEEP_ALIVE,
+  PROP_CACHE_ENABLED,
+  PROP_CACHE_DIRECTORY,
+  PROP_CACHE_MEMORY_SIZE,
+  PROP_SUGGESTION_CACHE_SIZE,
+  PROP_SUGGESTION_CACHE_TTL,
+  PROP_SUGGESTION_BATCH_WINDOW,
+  PROP_SUGGESTION_BATCH_SIZE,
+  PROP_MAX_REQUESTS_PER_HOST,
+  PROP_MAX_RETRIES,
+  PROP_RETRY_BASE_DELAY,
+  PROP_RETRY_MAX_DELAY,
+  PROP_RATE_LIMIT,
+  PROP_RATE_BURST,
+  PROP_DECODE_THREADS,
+  PROP_DECODE_THRESHOLD,
+  PROP_TIMEOUT,
+  PROP_COMPRESS_THRESHOLD,
   LAST_PROP
 };
 
 static GParamSpec *session_pspecs[LAST_PROP] = { 0 };
 
+typedef struct _HostQueue HostQueue;
+
+struct _HostQueue
+{
+  guint in_flight;
+  GQueue pending[ZANATA_REQUEST_PRIORITY_BULK + 1];
+};
+
+static HostQueue *
+host_queue_new (void)
+{
+  HostQueue *queue = g_slice_new0 (HostQueue);
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (queue->pending); i++)
+    g_queue_init (&queue->pending[i]);
+  return queue;
+}
+
+static void
+host_queue_free (HostQueue *queue)
+{
+  /* Queued tasks hold a reference to the session, so the queues are
+     always empty here.  */
+  g_slice_free (HostQueue, queue);
+}
+
+static void
+zanata_session_update_cache (ZanataSession *self)
+{
+  g_clear_pointer (&self->cache, _zanata_cache_free);
+  if (self->cache_enabled)
+    self->cache = _zanata_cache_new (self->cache_directory,
+                                     self->cache_memory_size);
+}
+
+/* The limiter is only created once the domain is known.  */
+static void
+zanata_session_update_rate_limit (ZanataSession *self)
+{
+  if (self->rate_limiter)
+    _zanata_rate_limiter_configure (self->rate_limiter,
+                                    self->rate_limit,
+                                    self->rate_burst);
+}
+
 static void
 zanata_session_set_property (GObject      *object,
                              guint         prop_id,
@@ -47,6 +220,122 @@ zanata_session_set_property (GObject      *object,
       self->domain = g_value_dup_string (value);
       break;
 
+    case PROP_MAX_CONNECTIONS_PER_HOST:
+      {
+        guint max_conns;
+
+        self->max_connections_per_host = g_value_get_uint (value);
+        g_object_get (self->soup_session,
+                      SOUP_SESSION_MAX_CONNS, &max_conns,
+                      NULL);
+        g_object_set (self->soup_session,
+                      SOUP_SESSION_MAX_CONNS,
+                      MAX (max_conns, self->max_connections_per_host),
+                      SOUP_SESSION_MAX_CONNS_PER_HOST,
+                      self->max_connections_per_host,
+                      NULL);
+      }
+      break;
+
+    case PROP_IDLE_TIMEOUT:
+      self->idle_timeout = g_value_get_uint (value);
+      g_object_set (self->soup_session,
+                    SOUP_SESSION_IDLE_TIMEOUT, self->idle_timeout,
+                    NULL);
+      break;
+
+    case PROP_KEEP_ALIVE:
+      self->keep_alive = g_value_get_boolean (value);
+      break;
+
+    case PROP_CACHE_ENABLED:
+      self->cache_enabled = g_value_get_boolean (value);
+      zanata_session_update_cache (self);
+      break;
+
+    case PROP_CACHE_DIRECTORY:
+      g_free (self->cache_directory);
+      self->cache_directory = g_value_dup_string (value);
+      zanata_session_update_cache (self);
+      break;
+
+    case PROP_CACHE_MEMORY_SIZE:
+      self->cache_memory_size = g_value_get_uint (value);
+      if (self->cache)
+        _zanata_cache_set_max_memory_size (self->cache,
+                                           self->cache_memory_size);
+      break;
+
+    case PROP_SUGGESTION_CACHE_SIZE:
+      self->suggestion_cache_size = g_value_get_uint (value);
+      _zanata_suggestion_cache_set_limits (self->suggestion_cache,
+                                           self->suggestion_cache_size,
+                                           self->suggestion_cache_ttl);
+      break;
+
+    case PROP_SUGGESTION_CACHE_TTL:
+      self->suggestion_cache_ttl = g_value_get_uint (value);
+      _zanata_suggestion_cache_set_limits (self->suggestion_cache,
+                                           self->suggestion_cache_size,
+                                           self->suggestion_cache_ttl);
+      break;
+
+    case PROP_SUGGESTION_BATCH_WINDOW:
+      self->suggestion_batch_window = g_value_get_uint (value);
+      break;
+
+    case PROP_SUGGESTION_BATCH_SIZE:
+      self->suggestion_batch_size = g_value_get_uint (value);
+      break;
+
+    case PROP_MAX_REQUESTS_PER_HOST:
+      g_mutex_lock (&self->scheduler_lock);
+      self->max_requests_per_host = g_value_get_uint (value);
+      g_mutex_unlock (&self->scheduler_lock);
+      break;
+
+    case PROP_MAX_RETRIES:
+      self->max_retries = g_value_get_uint (value);
+      break;
+
+    case PROP_RETRY_BASE_DELAY:
+      self->retry_base_delay = g_value_get_uint (value);
+      break;
+
+    case PROP_RETRY_MAX_DELAY:
+      self->retry_max_delay = g_value_get_uint (value);
+      break;
+
+    case PROP_RATE_LIMIT:
+      self->rate_limit = g_value_get_double (value);
+      zanata_session_update_rate_limit (self);
+      break;
+
+    case PROP_RATE_BURST:
+      self->rate_burst = g_value_get_uint (value);
+      zanata_session_update_rate_limit (self);
+      break;
+
+    case PROP_DECODE_THREADS:
+      self->decode_threads = g_value_get_uint (value);
+      if (self->decode_threads > 0)
+        g_thread_pool_set_max_threads (self->decode_pool,
+                                       self->decode_threads,
+                                       NULL);
+      break;
+
+    case PROP_DECODE_THRESHOLD:
+      self->decode_threshold = g_value_get_uint (value);
+      break;
+
+    case PROP_TIMEOUT:
+      self->timeout = g_value_get_uint (value);
+      break;
+
+    case PROP_COMPRESS_THRESHOLD:
+      self->compress_threshold = g_value_get_uint (value);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -71,28 +360,175 @@ zanata_session_get_property (GObject    *object,
       g_value_set_string (value, self->domain);
       break;
 
+    case PROP_MAX_CONNECTIONS_PER_HOST:
+      g_value_set_uint (value, self->max_connections_per_host);
+      break;
+
+    case PROP_IDLE_TIMEOUT:
+      g_value_set_uint (value, self->idle_timeout);
+      break;
+
+    case PROP_KEEP_ALIVE:
+      g_value_set_boolean (value, self->keep_alive);
+      break;
+
+    case PROP_CACHE_ENABLED:
+      g_value_set_boolean (value, self->cache_enabled);
+      break;
+
+    case PROP_CACHE_DIRECTORY:
+      g_value_set_string (value, self->cache_directory);
+      break;
+
+    case PROP_CACHE_MEMORY_SIZE:
+      g_value_set_uint (value, self->cache_memory_size);
+      break;
+
+    case PROP_SUGGESTION_CACHE_SIZE:
+      g_value_set_uint (value, self->suggestion_cache_size);
+      break;
+
+    case PROP_SUGGESTION_CACHE_TTL:
+      g_value_set_uint (value, self->suggestion_cache_ttl);
+      break;
+
+    case PROP_SUGGESTION_BATCH_WINDOW:
+      g_value_set_uint (value, self->suggestion_batch_window);
+      break;
+
+    case PROP_SUGGESTION_BATCH_SIZE:
+      g_value_set_uint (value, self->suggestion_batch_size);
+      break;
+
+    case PROP_MAX_REQUESTS_PER_HOST:
+      g_value_set_uint (value, self->max_requests_per_host);
+      break;
+
+    case PROP_MAX_RETRIES:
+      g_value_set_uint (value, self->max_retries);
+      break;
+
+    case PROP_RETRY_BASE_DELAY:
+      g_value_set_uint (value, self->retry_base_delay);
+      break;
+
+    case PROP_RETRY_MAX_DELAY:
+      g_value_set_uint (value, self->retry_max_delay);
+      break;
+
+    case PROP_RATE_LIMIT:
+      g_value_set_double (value, self->rate_limit);
+      break;
+
+    case PROP_RATE_BURST:
+      g_value_set_uint (value, self->rate_burst);
+      break;
+
+    case PROP_DECODE_THREADS:
+      g_value_set_uint (value, self->decode_threads);
+      break;
+
+    case PROP_DECODE_THRESHOLD:
+      g_value_set_uint (value, self->decode_threshold);
+      break;
+
+    case PROP_TIMEOUT:
+      g_value_set_uint (value, self->timeout);
+      break;
+
+    case PROP_COMPRESS_THRESHOLD:
+      g_value_set_uint (value, self->compress_threshold);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
     }
 }
 
+static void
+authorizer_changed_cb (ZanataAuthorizer *authorizer,
+                       gpointer          user_data)
+{
+  ZanataSession *self = ZANATA_SESSION (user_data);
+
+  g_mutex_lock (&self->base_lock);
+  g_clear_pointer (&self->base_uri, soup_uri_free);
+  g_clear_pointer (&self->base_path, g_free);
+  g_mutex_unlock (&self->base_lock);
+}
+
+static void
+zanata_session_constructed (GObject *object)
+{
+  ZanataSession *self = ZANATA_SESSION (object);
+
+  G_OBJECT_CLASS (zanata_session_parent_class)->constructed (object);
+
+  /* The domain may have been set after the rate limit.  */
+  self->rate_limiter = _zanata_rate_limiter_new (self->domain);
+  zanata_session_update_rate_limit (self);
+
+  if (self->authorizer)
+    self->authorizer_changed_id =
+      g_signal_connect (self->authorizer, "changed",
+                        G_CALLBACK (authorizer_changed_cb), self);
+}
+
 static void
 zanata_session_dispose (GObject *object)
 {
   ZanataSession *self = ZANATA_SESSION (object);
 
+  if (self->authorizer_changed_id > 0)
+    {
+      g_signal_handler_disconnect (self->authorizer,
+                                   self->authorizer_changed_id);
+      self->authorizer_changed_id = 0;
+    }
   g_clear_object (&self->authorizer);
+  g_clear_object (&self->soup_session);
 
   G_OBJECT_CLASS (zanata_session_parent_class)->dispose (object);
 }
 
+static void
+zanata_session_finalize (GObject *object)
+{
+  ZanataSession *self = ZANATA_SESSION (object);
+
+  g_free (self->domain);
+  g_clear_pointer (&self->rate_limiter, _zanata_rate_limiter_free);
+  g_clear_pointer (&self->cache, _zanata_cache_free);
+  g_free (self->cache_directory);
+  _zanata_suggestion_cache_free (self->suggestion_cache);
+  g_hash_table_unref (self->suggestion_batches);
+  g_mutex_clear (&self->suggestion_batches_lock);
+  g_hash_table_unref (self->project_loads);
+  g_mutex_clear (&self->project_loads_lock);
+  g_hash_table_unref (self->hosts);
+  g_mutex_clear (&self->scheduler_lock);
+  g_mutex_clear (&self->refresh_lock);
+  g_clear_pointer (&self->base_uri, soup_uri_free);
+  g_free (self->base_path);
+  g_mutex_clear (&self->base_lock);
+  _zanata_string_pool_unref (self->string_pool);
+  /* Each queued job holds a reference on the session, so the pool is
+     idle by now.  */
+  g_thread_pool_free (self->decode_pool, FALSE, FALSE);
+  g_mutex_clear (&self->stats_lock);
+
+  G_OBJECT_CLASS (zanata_session_parent_class)->finalize (object);
+}
+
 static void
 zanata_session_class_init (ZanataSessionClass *klass)
 {
   GObjectClass *object_class = G_OBJECT_CLASS (klass);
 
+  object_class->constructed = zanata_session_constructed;
   object_class->dispose = zanata_session_dispose;
+  object_class->finalize = zanata_session_finalize;
   object_class->set_property = zanata_session_set_property;
   object_class->get_property = zanata_session_get_property;
 
@@ -108,6 +544,126 @@ zanata_session_class_init (ZanataSessionClass *klass)
                          "The authorizion domain used to create a session.",
                          "",
                          G_PARAM_CONSTRUCT_ONLY | G_PARAM_READWRITE);
+  session_pspecs[PROP_MAX_CONNECTIONS_PER_HOST] =
+    g_param_spec_uint ("max-connections-per-host",
+                       "Max connections per host",
+                       "The maximum number of connections kept open to the server.",
+                       1, G_MAXUINT, DEFAULT_MAX_CONNECTIONS_PER_HOST,
+                       G_PARAM_CONSTRUCT | G_PARAM_READWRITE);
+  session_pspecs[PROP_IDLE_TIMEOUT] =
+    g_param_spec_uint ("idle-timeout",
+                       "Idle timeout",
+                       "Seconds before an idle connection is closed, or 0 to keep it open.",
+                       0, G_MAXUINT, DEFAULT_IDLE_TIMEOUT,
+                       G_PARAM_CONSTRUCT | G_PARAM_READWRITE);
+  session_pspecs[PROP_KEEP_ALIVE] =
+    g_param_spec_boolean ("keep-alive",
+                          "Keep alive",
+                          "Whether connections are reused across requests.",
+                          TRUE,
+                          G_PARAM_CONSTRUCT | G_PARAM_READWRITE);
+  session_pspecs[PROP_CACHE_ENABLED] =
+    g_param_spec_boolean ("cache-enabled",
+                          "Cache enabled",
+                          "Whether responses are revalidated with conditional requests.",
+                          FALSE,
+                          G_PARAM_CONSTRUCT | G_PARAM_READWRITE);
+  session_pspecs[PROP_CACHE_DIRECTORY] =
+    g_param_spec_string ("cache-directory",
+                         "Cache directory",
+                         "The directory where cached responses are kept, or NULL to keep them in memory only.",
+                         NULL,
+                         G_PARAM_CONSTRUCT | G_PARAM_READWRITE);
+  session_pspecs[PROP_CACHE_MEMORY_SIZE] =
+    g_param_spec_uint ("cache-memory-size",
+                       "Cache memory size",
+                       "The maximum number of bytes of cached response bodies kept in memory.",
+                       0, G_MAXUINT, DEFAULT_CACHE_MEMORY_SIZE,
+                       G_PARAM_CONSTRUCT | G_PARAM_READWRITE);
+  session_pspecs[PROP_SUGGESTION_CACHE_SIZE] =
+    g_param_spec_uint ("suggestion-cache-size",
+                       "Suggestion cache size",
+                       "The maximum number of suggestion lookups kept in memory, or 0 to disable caching.",
+                       0, G_MAXUINT, DEFAULT_SUGGESTION_CACHE_SIZE,
+                       G_PARAM_CONSTRUCT | G_PARAM_READWRITE);
+  session_pspecs[PROP_SUGGESTION_CACHE_TTL] =
+    g_param_spec_uint ("suggestion-cache-ttl",
+                       "Suggestion cache TTL",
+                       "Seconds before a cached suggestion lookup expires.",
+                       0, G_MAXUINT, DEFAULT_SUGGESTION_CACHE_TTL,
+                       G_PARAM_CONSTRUCT | G_PARAM_READWRITE);
+  session_pspecs[PROP_SUGGESTION_BATCH_WINDOW] =
+    g_param_spec_uint ("suggestion-batch-window",
+                       "Suggestion batch window",
+                       "Milliseconds to wait for identical suggestion lookups to coalesce, or 0 to send each lookup immediately.",
+                       0, G_MAXUINT, 0,
+                       G_PARAM_CONSTRUCT | G_PARAM_READWRITE);
+  session_pspecs[PROP_SUGGESTION_BATCH_SIZE] =
+    g_param_spec_uint ("suggestion-batch-size",
+                       "Suggestion batch size",
+                       "The number of coalesced callers which causes a suggestion lookup to be sent before the window elapses.",
+                       1, G_MAXUINT, DEFAULT_SUGGESTION_BATCH_SIZE,
+                       G_PARAM_CONSTRUCT | G_PARAM_READWRITE);
+  session_pspecs[PROP_MAX_REQUESTS_PER_HOST] =
+    g_param_spec_uint ("max-requests-per-host",
+                       "Max requests per host",
+                       "The maximum number of requests in flight to a host; others are queued by priority.",
+                       1, G_MAXUINT, DEFAULT_MAX_CONNECTIONS_PER_HOST,
+                       G_PARAM_CONSTRUCT | G_PARAM_READWRITE);
+  session_pspecs[PROP_MAX_RETRIES] =
+    g_param_spec_uint ("max-retries",
+                       "Max retries",
+                       "The number of times an idempotent request is retried after a transient failure.",
+                       0, G_MAXUINT, DEFAULT_MAX_RETRIES,
+                       G_PARAM_CONSTRUCT | G_PARAM_READWRITE);
+  session_pspecs[PROP_RETRY_BASE_DELAY] =
+    g_param_spec_uint ("retry-base-delay",
+                       "Retry base delay",
+                       "Milliseconds to wait before the first retry, doubled for each further retry.",
+                       0, G_MAXUINT, DEFAULT_RETRY_BASE_DELAY,
+                       G_PARAM_CONSTRUCT | G_PARAM_READWRITE);
+  session_pspecs[PROP_RETRY_MAX_DELAY] =
+    g_param_spec_uint ("retry-max-delay",
+                       "Retry max delay",
+                       "The maximum number of milliseconds to wait before a retry.",
+                       0, G_MAXUINT, DEFAULT_RETRY_MAX_DELAY,
+                       G_PARAM_CONSTRUCT | G_PARAM_READWRITE);
+  session_pspecs[PROP_RATE_LIMIT] =
+    g_param_spec_double ("rate-limit",
+                         "Rate limit",
+                         "The sustained number of requests per second allowed to the authorization domain, or 0 for no limit.",
+                         0, G_MAXDOUBLE, 0,
+                         G_PARAM_CONSTRUCT | G_PARAM_READWRITE);
+  session_pspecs[PROP_RATE_BURST] =
+    g_param_spec_uint ("rate-burst",
+                       "Rate burst",
+                       "The number of requests which can be sent at once above the rate limit.",
+                       1, G_MAXUINT, DEFAULT_RATE_BURST,
+                       G_PARAM_CONSTRUCT | G_PARAM_READWRITE);
+  session_pspecs[PROP_DECODE_THREADS] =
+    g_param_spec_uint ("decode-threads",
+                       "Decode threads",
+                       "The number of threads decoding large responses, or 0 to decode them in the caller's main context.",
+                       0, G_MAXUINT, DEFAULT_DECODE_THREADS,
+                       G_PARAM_CONSTRUCT | G_PARAM_READWRITE);
+  session_pspecs[PROP_DECODE_THRESHOLD] =
+    g_param_spec_uint ("decode-threshold",
+                       "Decode threshold",
+                       "The size in bytes from which a response is decoded in a worker thread.",
+                       0, G_MAXUINT, DEFAULT_DECODE_THRESHOLD,
+                       G_PARAM_CONSTRUCT | G_PARAM_READWRITE);
+  session_pspecs[PROP_TIMEOUT] =
+    g_param_spec_uint ("timeout",
+                       "Timeout",
+                       "Milliseconds before a request and the reading of its response are aborted, or 0 for no limit.",
+                       0, G_MAXUINT, DEFAULT_TIMEOUT,
+                       G_PARAM_CONSTRUCT | G_PARAM_READWRITE);
+  session_pspecs[PROP_COMPRESS_THRESHOLD] =
+    g_param_spec_uint ("compress-threshold",
+                       "Compress threshold",
+                       "The size in bytes from which request bodies are sent gzip-compressed, or 0 to never compress them.",
+                       0, G_MAXUINT, 0,
+                       G_PARAM_CONSTRUCT | G_PARAM_READWRITE);
   g_object_class_install_properties (object_class, LAST_PROP,
                                      session_pspecs);
 }
@@ -115,6 +671,31 @@ zanata_session_class_init (ZanataSessionClass *klass)
 static void
 zanata_session_init (ZanataSession *self)
 {
+  self->soup_session = soup_session_new ();
+  /* Responses are decoded by the session itself, so that the bytes
+     received can be counted before decoding.  */
+  soup_session_remove_feature_by_type (self->soup_session,
+                                       SOUP_TYPE_CONTENT_DECODER);
+  self->suggestion_cache =
+    _zanata_suggestion_cache_new (DEFAULT_SUGGESTION_CACHE_SIZE,
+                                  DEFAULT_SUGGESTION_CACHE_TTL);
+  g_mutex_init (&self->suggestion_batches_lock);
+  self->suggestion_batches = g_hash_table_new (g_str_hash, g_str_equal);
+  g_mutex_init (&self->project_loads_lock);
+  self->project_loads = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                               g_free, NULL);
+  g_mutex_init (&self->scheduler_lock);
+  self->hosts = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                       g_free,
+                                       (GDestroyNotify) host_queue_free);
+  g_mutex_init (&self->refresh_lock);
+  g_queue_init (&self->refresh_waiters);
+  g_mutex_init (&self->base_lock);
+  self->string_pool = _zanata_string_pool_new ();
+  self->decode_pool = g_thread_pool_new (decode_job_run, NULL,
+                                         DEFAULT_DECODE_THREADS, FALSE,
+                                         NULL);
+  g_mutex_init (&self->stats_lock);
 }
 
 ZanataSession *
@@ -147,6 +728,40 @@ zanata_parameter_free (ZanataParameter *parameter)
 G_DEFINE_BOXED_TYPE (ZanataParameter, zanata_parameter,
                      zanata_parameter_copy, zanata_parameter_free)
 
+/* Must be called with the base lock held.  */
+static gboolean
+ensure_base_uri (ZanataSession *self)
+{
+  const gchar *path;
+  gchar *url;
+  gsize length;
+
+  if (self->base_uri)
+    return TRUE;
+
+  url = zanata_authorizer_get_url (self->authorizer, self->domain);
+  if (url)
+    self->base_uri = soup_uri_new (url);
+  if (!self->base_uri)
+    {
+      g_warning ("invalid URL for domain %s: %s",
+                 self->domain ? self->domain : "(default)",
+                 url ? url : "(none)");
+      g_free (url);
+      return FALSE;
+    }
+  g_free (url);
+
+  path = soup_uri_get_path (self->base_uri);
+  if (path == NULL)
+    path = "";
+  length = strlen (path);
+  if (length > 0 && path[length - 1] == '/')
+    length--;
+  self->base_path = g_strndup (path, length);
+  return TRUE;
+}
+
 /**
  * zanata_session_get_endpoint:
  * @session: a #ZanataSession
@@ -160,665 +775,2627 @@ zanata_session_get_endpoint (ZanataSession *session,
                              const gchar   *mountpoint)
 {
   SoupURI *result;
-  const gchar *orig_path;
-
-  result =
-    soup_uri_new (zanata_authorizer_get_url (session->authorizer,
-                                             session->domain));
-  orig_path = soup_uri_get_path (result);
-  if (orig_path == NULL || *orig_path == '\0')
-    soup_uri_set_path (result, mountpoint);
-  else
+  gchar *path;
+
+  g_return_val_if_fail (ZANATA_IS_SESSION (session), NULL);
+
+  g_mutex_lock (&session->base_lock);
+  if (!ensure_base_uri (session))
     {
-      gchar *copy_path = g_strdup (orig_path);
-      gchar *path, *p = copy_path + strlen (copy_path) - 1;
-      if (*p == '/')
-        *p = '\0';
-      path = g_strdup_printf ("%s%s", copy_path, mountpoint);
-      g_free (copy_path);
-      soup_uri_set_path (result, path);
-      g_free (path);
+      g_mutex_unlock (&session->base_lock);
+      return NULL;
     }
+  result = soup_uri_copy (session->base_uri);
+  path = g_strconcat (session->base_path, mountpoint, NULL);
+  g_mutex_unlock (&session->base_lock);
+
+  soup_uri_set_path (result, path);
+  g_free (path);
   return result;
 }
 
-static void
-invoke_with_soup_cb (GObject      *source_object,
-                     GAsyncResult *res,
-                     gpointer      user_data)
+/* Returns: (transfer full): the URI of ENDPOINT, whose template is
+   filled with ARGS.  The caller must pass as many arguments as the
+   template has placeholders.  */
+SoupURI *
+_zanata_session_build_endpoint (ZanataSession       *session,
+                                ZanataEndpoint       endpoint,
+                                const gchar * const *args)
 {
-  SoupSession *session = SOUP_SESSION (source_object);
-  GTask *task = G_TASK (user_data);
-  GError *error = NULL;
-  GInputStream *stream;
+  SoupURI *result;
+  gchar *path;
 
-  stream = soup_session_send_finish (session, res, &error);
-  if (!stream)
+  g_mutex_lock (&session->base_lock);
+  if (!ensure_base_uri (session))
     {
-      g_task_return_error (task, error);
-      g_object_unref (task);
-      return;
+      g_mutex_unlock (&session->base_lock);
+      return NULL;
     }
+  result = soup_uri_copy (session->base_uri);
+  path = _zanata_endpoint_expand (endpoint, session->base_path, args);
+  g_mutex_unlock (&session->base_lock);
 
-  g_task_return_pointer (task, stream, g_object_unref);
-  g_object_unref (task);
+  soup_uri_set_path (result, path);
+  g_free (path);
+  return result;
 }
 
-static void
-invoke_with_rest_cb (GObject      *source_object,
-                     GAsyncResult *res,
-                     gpointer      user_data)
+/* Returns: (transfer none): the pool in which decoders intern
+   repetitive strings.  */
+ZanataStringPool *
+_zanata_session_get_string_pool (ZanataSession *session)
 {
-  RestProxyCall *call = REST_PROXY_CALL (source_object);
-  GTask *task = G_TASK (user_data);
-  GError *error = NULL;
-  const gchar *payload;
-  goffset payload_length;
-  GInputStream *stream;
+  return session->string_pool;
+}
+
+/**
+ * zanata_session_get_queue_depth:
+ * @session: a #ZanataSession
+ * @priority: a #ZanataRequestPriority
+ *
+ * Returns the number of requests of @priority waiting for a free slot,
+ * across all hosts.  Requests already in flight are not counted.
+ *
+ * Returns: the number of queued requests
+ */
+guint
+zanata_session_get_queue_depth (ZanataSession         *session,
+                                ZanataRequestPriority  priority)
+{
+  GHashTableIter iter;
+  gpointer value;
+  guint depth = 0;
 
-  if (!rest_proxy_call_invoke_finish (call, res, &error))
+  g_return_val_if_fail (ZANATA_IS_SESSION (session), 0);
+  g_return_val_if_fail (priority <= ZANATA_REQUEST_PRIORITY_BULK, 0);
+
+  g_mutex_lock (&session->scheduler_lock);
+  g_hash_table_iter_init (&iter, session->hosts);
+  while (g_hash_table_iter_next (&iter, NULL, &value))
     {
-      g_task_return_error (task, error);
-      g_object_unref (task);
-      return;
+      HostQueue *queue = value;
+      depth += g_queue_get_length (&queue->pending[priority]);
     }
+  g_mutex_unlock (&session->scheduler_lock);
 
-  payload = rest_proxy_call_get_payload (call);
-  payload_length = rest_proxy_call_get_payload_length (call);
-  stream = g_memory_input_stream_new_from_data (payload,
-                                                payload_length,
-                                                g_free);
-  g_task_return_pointer (task, stream, g_object_unref);
-  g_object_unref (task);
+  return depth;
 }
 
-static void
-zanata_session_invoke_with_soup (ZanataSession       *session,
-                                 const gchar         *method,
-                                 SoupURI             *endpoint,
-                                 ZanataParameter    **parameters,
-                                 const gchar         *request_content_type,
-                                 const gchar         *request,
-                                 gsize                request_length,
-                                 const gchar         *response_content_type,
-                                 GCancellable        *cancellable,
-                                 GAsyncReadyCallback  callback,
-                                 gpointer             user_data)
+/* The deadline of a request.  It cancels CANCELLABLE, which is
+   chained to the caller's cancellable and used for every stage of the
+   send operation, and aborts the current message so that the reading
+   of a streamed response body is cut off too.  Each message holds a
+   reference on it, so that it outlives the send operation until the
+   body has been read.  */
+typedef struct _SendDeadline SendDeadline;
+
+struct _SendDeadline
 {
-  GTask *task;
+  gint ref_count;
+  GCancellable *cancellable;
+  GCancellable *parent;
+  gulong parent_handler;
+  GSource *source;
+  gint expired;
+
+  /* The message being sent or read, if not finished yet.  */
   SoupSession *soup_session;
-  SoupMessage *soup_message;
-  SoupURI *uri;
+  SoupMessage *message;
+};
 
-  task = g_task_new (session, cancellable, callback, user_data);
+static void
+send_deadline_parent_cancelled_cb (GCancellable *parent,
+                                   gpointer      user_data)
+{
+  SendDeadline *deadline = user_data;
 
-  soup_session = soup_session_new ();
-  uri = soup_uri_copy (endpoint);
-  if (parameters != NULL)
-    {
-      GPtrArray *array;
-      gchar **strv;
-      gchar *query;
+  g_cancellable_cancel (deadline->cancellable);
+}
 
-      array = g_ptr_array_new_with_free_func (g_free);
-      while (*parameters)
-        {
-          ZanataParameter *parameter = *parameters;
-          gchar *escaped_parameter;
-
-          escaped_parameter =
-            g_strdup_printf ("%s=%s",
-                             soup_uri_encode (parameter->name, NULL),
-                             soup_uri_encode (parameter->value, NULL));
-          g_ptr_array_add (array, escaped_parameter);
-          parameters++;
-        }
-      g_ptr_array_add (array, NULL);
+static gboolean
+send_deadline_expired_cb (gpointer user_data)
+{
+  SendDeadline *deadline = user_data;
+  SoupMessage *message = deadline->message;
+
+  g_atomic_int_set (&deadline->expired, TRUE);
+  g_cancellable_cancel (deadline->cancellable);
+
+  /* This may finish the message and drop the last reference on the
+     deadline.  */
+  if (message != NULL)
+    soup_session_cancel_message (deadline->soup_session,
+                                 message,
+                                 SOUP_STATUS_CANCELLED);
+  return G_SOURCE_REMOVE;
+}
 
-      strv = (gchar **) g_ptr_array_free (array, FALSE);
-      query = g_strjoinv ("&", strv);
-      g_strfreev (strv);
+static SendDeadline *
+send_deadline_new (ZanataSession *session,
+                   GCancellable  *parent,
+                   guint          timeout)
+{
+  SendDeadline *deadline = g_slice_new0 (SendDeadline);
 
-      soup_uri_set_query (uri, query);
+  deadline->ref_count = 1;
+  deadline->cancellable = g_cancellable_new ();
+  deadline->soup_session = g_object_ref (session->soup_session);
+  if (parent)
+    {
+      deadline->parent = g_object_ref (parent);
+      deadline->parent_handler =
+        g_cancellable_connect (parent,
+                               G_CALLBACK (send_deadline_parent_cancelled_cb),
+                               deadline,
+                               NULL);
     }
-  soup_message = soup_message_new_from_uri (method, uri);
-  soup_uri_free (uri);
 
-  if (request != NULL)
-    soup_message_set_request (soup_message,
-                              request_content_type,
-                              SOUP_MEMORY_COPY,
-                              request,
-                              request_length);
+  deadline->source = g_timeout_source_new (timeout);
+  g_source_set_callback (deadline->source,
+                         send_deadline_expired_cb,
+                         deadline,
+                         NULL);
+  g_source_attach (deadline->source, g_main_context_get_thread_default ());
+  return deadline;
+}
 
-  zanata_authorizer_process_message (session->authorizer,
-                                     session->domain,
-                                     soup_message);
+static SendDeadline *
+send_deadline_ref (SendDeadline *deadline)
+{
+  g_atomic_int_inc (&deadline->ref_count);
+  return deadline;
+}
 
-  if (response_content_type != NULL)
-    soup_message_headers_append (soup_message->request_headers,
-                                 "Accept", response_content_type);
+static void
+send_deadline_unref (SendDeadline *deadline)
+{
+  if (!g_atomic_int_dec_and_test (&deadline->ref_count))
+    return;
 
-  soup_session_send_async (soup_session, soup_message, NULL,
-                           invoke_with_soup_cb, task);
+  g_source_destroy (deadline->source);
+  g_source_unref (deadline->source);
+  if (deadline->parent)
+    {
+      g_cancellable_disconnect (deadline->parent, deadline->parent_handler);
+      g_object_unref (deadline->parent);
+    }
+  g_object_unref (deadline->cancellable);
+  g_object_unref (deadline->soup_session);
+  g_slice_free (SendDeadline, deadline);
+}
 
-  g_object_unref (soup_message);
-  g_object_unref (soup_session);
+/* Whether the operation failed because its deadline passed, rather
+   than because the caller cancelled it.  */
+static gboolean
+send_deadline_is_expired (SendDeadline *deadline)
+{
+  return deadline != NULL
+    && g_atomic_int_get (&deadline->expired)
+    && !g_cancellable_is_cancelled (deadline->parent);
 }
 
+/* Replaces the error of an operation whose deadline has passed.  */
 static void
-zanata_session_invoke_with_rest (ZanataSession       *session,
-                                 const gchar         *method,
-                                 SoupURI             *endpoint,
-                                 ZanataParameter    **parameters,
-                                 const gchar         *request_content_type,
-                                 const gchar         *request,
-                                 gsize                request_length,
-                                 const gchar         *response_content_type,
-                                 GCancellable        *cancellable,
-                                 GAsyncReadyCallback  callback,
-                                 gpointer             user_data)
+send_deadline_check_error (SendDeadline  *deadline,
+                           GError       **error)
 {
-  GTask *task;
-  RestProxy *proxy;
-  RestProxyCall *call;
-  gchar *uri_string;
+  if (error == NULL || *error == NULL || !send_deadline_is_expired (deadline))
+    return;
 
-  task = g_task_new (session, cancellable, callback, user_data);
-  uri_string = soup_uri_to_string (endpoint, FALSE);
-  proxy = rest_proxy_new (uri_string, FALSE);
-  g_free (uri_string);
-
-  call = rest_proxy_new_call (proxy);
-  zanata_authorizer_process_call (session->authorizer,
-                                  session->domain,
-                                  call);
-  if (parameters != NULL)
-    {
-      while (*parameters)
-        {
-          ZanataParameter *parameter = *parameters;
-          rest_proxy_call_add_param (call,
-                                     (const gchar *) parameter->name,
-                                     (const gchar *) parameter->value);
-          parameters++;
-        }
-    }
+  g_clear_error (error);
+  g_set_error_literal (error,
+                       ZANATA_ERROR,
+                       ZANATA_ERROR_TIMED_OUT,
+                       "The request timed out");
+}
 
-  if (response_content_type != NULL)
-    rest_proxy_call_add_header (call, "Accept", response_content_type);
-  rest_proxy_call_set_method (call, method);
-  rest_proxy_call_invoke_async (call, cancellable, invoke_with_rest_cb, task);
+static void
+send_deadline_message_finished_cb (SoupMessage *message,
+                                   gpointer     user_data)
+{
+  SendDeadline *deadline = user_data;
 
-  g_object_unref (proxy);
-  g_object_unref (call);
+  if (deadline->message == message)
+    deadline->message = NULL;
 }
 
-/**
- * zanata_session_invoke:
- * @session: a #ZanataSession
- * @method: a string
- * @endpoint: a #SoupURI
- * @parameters: (nullable): (array zero-terminated=1) (element-type ZanataParameter): an array of parameters
- * @request_content_type: (nullable): a string
- * @request: (nullable): a string
- * @request_length: the length of request or -1
- * @response_content_type: (nullable): a string
- * @cancellable: (nullable): a #GCancellable
- * @callback: a #GAsyncReadyCallback
- * @user_data: (nullable): a user data
- *
- * Starts invoking a REST call.  This operation is asynchronous and
- * shall be finished with zanata_session_invoke_finish().
- */
-void
-zanata_session_invoke (ZanataSession       *session,
-                       const gchar         *method,
-                       SoupURI             *endpoint,
-                       ZanataParameter    **parameters,
-                       const gchar         *request_content_type,
-                       const gchar         *request,
-                       gsize                request_length,
-                       const gchar         *response_content_type,
-                       GCancellable        *cancellable,
-                       GAsyncReadyCallback  callback,
-                       gpointer             user_data)
+static void
+send_deadline_closure_free (gpointer  user_data,
+                            GClosure *closure)
 {
-  if (parameters != NULL)
-    zanata_session_invoke_with_soup (session,
-                                     method,
-                                     endpoint,
-                                     parameters,
-                                     request_content_type,
-                                     request,
-                                     request_length,
-                                     response_content_type,
-                                     cancellable,
-                                     callback,
-                                     user_data);
-  else
-    zanata_session_invoke_with_rest (session,
-                                     method,
-                                     endpoint,
-                                     parameters,
-                                     request_content_type,
-                                     request,
-                                     request_length,
-                                     response_content_type,
-                                     cancellable,
-                                     callback,
-                                     user_data);
+  send_deadline_unref (user_data);
 }
 
-/**
- * zanata_session_invoke_finish:
- * @session: a #ZanataSession
- * @result: a #GAsyncResult
- * @error: error location
- *
- * Finishes zanata_session_invoke() operation.
- *
- * Returns: (transfer full): a #GInputStream.
- */
-GInputStream *
-zanata_session_invoke_finish (ZanataSession  *session,
-                              GAsyncResult   *result,
-                              GError        **error)
+static void
+send_deadline_set_message (SendDeadline *deadline,
+                           SoupMessage  *message)
 {
-  g_return_val_if_fail (g_task_is_valid (result, session), NULL);
+  deadline->message = message;
+  g_signal_connect_data (message, "finished",
+                         G_CALLBACK (send_deadline_message_finished_cb),
+                         send_deadline_ref (deadline),
+                         send_deadline_closure_free, 0);
+}
 
-  return g_task_propagate_pointer (G_TASK (result), error);
+typedef struct _SendData SendData;
+
+struct _SendData
+{
+  ZanataRequest *request;
+  SoupMessage *message;
+
+  /* Set for requests revalidated through the conditional-request
+     cache.  */
+  gchar *cache_key;
+  gboolean keep_body;
+
+  /* Set once a 304 Not Modified response has found nothing left in
+     the cache, so that the request is resent without validators.  */
+  gboolean unconditional;
+
+  /* The decoded object answering a 304 Not Modified response.  */
+  GObject *cached_object;
+
+  /* The host whose slot the request takes, and the source watching
+     the cancellable while the request is queued.  */
+  gchar *host;
+  ZanataRequestPriority priority;
+  GSource *cancel_source;
+
+  /* Retry state.  The message is rebuilt from the request for each
+     attempt.  */
+  guint attempt;
+  guint auth_generation;
+  gboolean auth_refreshed;
+
+  /* Pending backoff or rate-limit delay.  */
+  GSource *wait_source;
+  gboolean rate_reserved;
+
+  /* The response body, if it has been read into memory.  */
+  GBytes *body;
+
+  /* The deadline of the whole operation, if any.  */
+  SendDeadline *deadline;
+};
+
+static void
+send_data_free (SendData *data)
+{
+  g_object_unref (data->request);
+  g_clear_object (&data->message);
+  g_free (data->cache_key);
+  g_clear_object (&data->cached_object);
+  g_free (data->host);
+  g_clear_pointer (&data->body, g_bytes_unref);
+  g_clear_pointer (&data->deadline, send_deadline_unref);
+  g_slice_free (SendData, data);
 }
 
+/* A host slot held by a message.  It is released when the message is
+   finished, which for a streamed response is when the body has been
+   read or the stream closed, or at the latest when the message is
+   destroyed.  */
+typedef struct _SendSlot SendSlot;
+
+struct _SendSlot
+{
+  ZanataSession *session;
+  gchar *host;
+  gboolean released;
+};
+
+static void send_release (ZanataSession *session,
+                          const gchar   *host);
+
 static void
-collect_suggestions (JsonArray *array,
-                     guint      index_,
-                     JsonNode  *element_node,
-                     gpointer   user_data)
+send_slot_release (SendSlot *slot)
 {
-  GList **suggestions = user_data;
-  JsonObject *object;
-  JsonArray *value_array;
-  ZanataSuggestion *suggestion;
-  gchar **source_contents;
-  gchar **target_contents;
-  guint length, i, j;
+  if (!slot->released)
+    {
+      slot->released = TRUE;
+      send_release (slot->session, slot->host);
+    }
+}
 
-  if (json_node_get_node_type (element_node) != JSON_NODE_OBJECT)
-    return;
+static void
+send_slot_free (gpointer  user_data,
+                GClosure *closure)
+{
+  SendSlot *slot = user_data;
 
-  object = json_node_get_object (element_node);
-  value_array = json_object_get_array_member (object, "sourceContents");
-  if (!value_array)
-    return;
+  send_slot_release (slot);
+  g_object_unref (slot->session);
+  g_free (slot->host);
+  g_slice_free (SendSlot, slot);
+}
+
+static void
+send_message_finished_cb (SoupMessage *message,
+                          gpointer     user_data)
+{
+  send_slot_release (user_data);
+}
+
+static void send_start (GTask *task);
+
+static gboolean
+send_can_retry (GTask *task)
+{
+  ZanataSession *session = g_task_get_source_object (task);
+  SendData *data = g_task_get_task_data (task);
+
+  return data->attempt < session->max_retries
+    && _zanata_request_is_idempotent (data->request)
+    && _zanata_request_can_replay (data->request);
+}
 
-  length = json_array_get_length (value_array);
-  source_contents = g_new0 (gchar *, length);
-  for (i = 0, j = 0; i < length; i++)
+static gboolean
+is_transient_error (const GError *error)
+{
+  if (error->domain == G_IO_ERROR)
     {
-      const gchar *value = json_array_get_string_element (value_array, i);
-      if (value)
-        source_contents[j++] = g_strdup (value);
+      switch (error->code)
+        {
+        case G_IO_ERROR_TIMED_OUT:
+        case G_IO_ERROR_CONNECTION_REFUSED:
+        case G_IO_ERROR_BROKEN_PIPE:
+        case G_IO_ERROR_HOST_UNREACHABLE:
+        case G_IO_ERROR_NETWORK_UNREACHABLE:
+        case G_IO_ERROR_NOT_CONNECTED:
+        case G_IO_ERROR_PARTIAL_INPUT:
+          return TRUE;
+        default:
+          return FALSE;
+        }
     }
 
-  value_array = json_object_get_array_member (object, "targetContents");
-  if (!value_array)
-    return;
+  return g_error_matches (error,
+                          G_RESOLVER_ERROR,
+                          G_RESOLVER_ERROR_TEMPORARY_FAILURE);
+}
 
-  length = json_array_get_length (value_array);
-  target_contents = g_new0 (gchar *, length);
-  for (i = 0, j = 0; i < length; i++)
+static gboolean
+is_transient_status (guint status)
+{
+  switch (status)
     {
-      const gchar *value = json_array_get_string_element (value_array, i);
-      if (value)
-        target_contents[j++] = g_strdup (value);
+    case SOUP_STATUS_REQUEST_TIMEOUT:
+    case 429:                   /* Too Many Requests */
+    case SOUP_STATUS_INTERNAL_SERVER_ERROR:
+    case SOUP_STATUS_BAD_GATEWAY:
+    case SOUP_STATUS_SERVICE_UNAVAILABLE:
+    case SOUP_STATUS_GATEWAY_TIMEOUT:
+      return TRUE;
+    default:
+      return FALSE;
     }
+}
 
-  suggestion = g_object_new (ZANATA_TYPE_SUGGESTION,
-                             "source-contents", source_contents,
-                             "target-contents", target_contents,
-                             NULL);
-  *suggestions = g_list_append (*suggestions, suggestion);
+/* Returns the delay requested by a Retry-After header in
+   milliseconds, or -1 if there is none.  */
+static gint64
+parse_retry_after (SoupMessageHeaders *headers)
+{
+  const gchar *value;
+  SoupDate *date;
+  gint64 delay;
+
+  value = soup_message_headers_get_one (headers, "Retry-After");
+  if (value == NULL)
+    return -1;
+
+  if (g_ascii_isdigit (*value))
+    {
+      gchar *end;
+      guint64 seconds = g_ascii_strtoull (value, &end, 10);
+
+      if (*end != '\0' || seconds > G_MAXINT64 / 1000)
+        return -1;
+      return (gint64) seconds * 1000;
+    }
+
+  date = soup_date_new_from_string (value);
+  if (date == NULL)
+    return -1;
+
+  delay = (gint64) soup_date_to_time_t (date) * 1000
+    - g_get_real_time () / 1000;
+  soup_date_free (date);
+  return MAX (delay, 0);
+}
+
+/* Exponential backoff with jitter: the Nth retry waits between half
+   and the whole of BASE * 2^N, so that clients which failed together
+   do not retry in lockstep.  A Retry-After delay given by the server
+   takes precedence, within the same upper bound.  */
+static guint
+compute_retry_delay (ZanataSession *session,
+                     guint          attempt,
+                     gint64         retry_after)
+{
+  gdouble delay = session->retry_base_delay;
+  guint i;
+
+  for (i = 0; i < attempt && delay < session->retry_max_delay; i++)
+    delay *= 2;
+  delay = MIN (delay, session->retry_max_delay);
+  delay = g_random_double_range (delay / 2, delay);
+
+  if (retry_after >= 0)
+    delay = MAX (delay, MIN (retry_after, session->retry_max_delay));
+
+  return (guint) delay;
 }
 
+/* Calls FUNC on TASK after DELAY milliseconds, or as soon as its
+   cancellable is triggered, so that the caller does not have to wait
+   for the delay to elapse to see the cancellation.  */
 static void
-free_suggestions (GList *suggestions)
+send_wait (GTask       *task,
+           guint        delay,
+           GSourceFunc  func)
+{
+  SendData *data = g_task_get_task_data (task);
+  GCancellable *cancellable = g_task_get_cancellable (task);
+
+  data->wait_source = g_timeout_source_new (delay);
+  if (cancellable)
+    {
+      GSource *cancel_source = g_cancellable_source_new (cancellable);
+
+      g_source_set_dummy_callback (cancel_source);
+      g_source_add_child_source (data->wait_source, cancel_source);
+      g_source_unref (cancel_source);
+    }
+  g_source_set_callback (data->wait_source, func, task, NULL);
+  g_source_attach (data->wait_source, g_main_context_get_thread_default ());
+}
+
+static gboolean
+send_retry_cb (gpointer user_data)
 {
-  g_list_free_full (suggestions, g_object_unref);
+  GTask *task = G_TASK (user_data);
+  SendData *data = g_task_get_task_data (task);
+
+  g_clear_pointer (&data->wait_source, g_source_unref);
+  send_start (task);
+  return G_SOURCE_REMOVE;
 }
 
 static void
-get_suggestions_load_cb (GObject      *source_object,
-                         GAsyncResult *res,
-                         gpointer      user_data)
+send_retry_later (GTask *task,
+                  guint  delay)
+{
+  SendData *data = g_task_get_task_data (task);
+
+  data->attempt++;
+  send_wait (task, delay, send_retry_cb);
+}
+
+static void
+refresh_authorization_cb (GObject      *source_object,
+                          GAsyncResult *res,
+                          gpointer      user_data)
+{
+  ZanataSession *session = ZANATA_SESSION (user_data);
+  GError *error = NULL;
+  GQueue waiters;
+  GTask *task;
+
+  zanata_authorizer_refresh_authorization_finish (ZANATA_AUTHORIZER (source_object),
+                                                  res,
+                                                  &error);
+
+  g_mutex_lock (&session->refresh_lock);
+  session->refreshing = FALSE;
+  if (!error)
+    g_atomic_int_inc (&session->auth_generation);
+  waiters = session->refresh_waiters;
+  g_queue_init (&session->refresh_waiters);
+  g_mutex_unlock (&session->refresh_lock);
+
+  while ((task = g_queue_pop_head (&waiters)) != NULL)
+    {
+      if (error)
+        {
+          g_task_return_error (task, g_error_copy (error));
+          g_object_unref (task);
+        }
+      else
+        send_start (task);
+    }
+
+  g_clear_error (&error);
+  g_object_unref (session);
+}
+
+/* Replays the request of TASK, which was rejected with 401, once the
+   authorizer has been refreshed.  Concurrent rejections share a
+   single refresh.  */
+static void
+send_refresh_authorization (GTask *task)
+{
+  ZanataSession *session = g_task_get_source_object (task);
+  SendData *data = g_task_get_task_data (task);
+  gboolean start;
+
+  g_mutex_lock (&session->refresh_lock);
+  if (data->auth_generation != session->auth_generation)
+    {
+      /* Refreshed since the request was sent.  */
+      g_mutex_unlock (&session->refresh_lock);
+      send_start (task);
+      return;
+    }
+
+  g_queue_push_tail (&session->refresh_waiters, task);
+  start = !session->refreshing;
+  session->refreshing = TRUE;
+  g_mutex_unlock (&session->refresh_lock);
+
+  if (start)
+    zanata_authorizer_refresh_authorization (session->authorizer,
+                                             NULL,
+                                             refresh_authorization_cb,
+                                             g_object_ref (session));
+}
+
+void
+_zanata_session_add_received (ZanataSession *session,
+                              gsize          received,
+                              gsize          decoded)
+{
+  g_mutex_lock (&session->stats_lock);
+  session->bytes_received += received;
+  session->bytes_received_decoded += decoded;
+  g_mutex_unlock (&session->stats_lock);
+}
+
+static void
+add_sent (ZanataSession *session,
+          gsize          sent,
+          gsize          uncompressed)
+{
+  g_mutex_lock (&session->stats_lock);
+  session->bytes_sent += sent;
+  session->bytes_sent_uncompressed += uncompressed;
+  g_mutex_unlock (&session->stats_lock);
+}
+
+static void
+send_wrote_body_data_cb (SoupMessage *message,
+                         SoupBuffer  *chunk,
+                         gpointer     user_data)
+{
+  add_sent (user_data, chunk->length, chunk->length);
+}
+
+/* The uncompressed size of a compressed body is accounted for when it
+   is dispatched.  */
+static void
+send_wrote_compressed_body_data_cb (SoupMessage *message,
+                                    SoupBuffer  *chunk,
+                                    gpointer     user_data)
+{
+  add_sent (user_data, chunk->length, 0);
+}
+
+/* Wraps the response body of MESSAGE into a stream decoding its
+   content coding, and counting the bytes received.  Returns NULL if
+   the coding is not supported.  */
+static GInputStream *
+decode_response_stream (ZanataSession *session,
+                        SoupMessage   *message,
+                        GInputStream  *stream)
+{
+  const gchar *coding;
+  GConverter *decoder = NULL;
+  GConverter *converter;
+  GInputStream *decoded;
+
+  coding = soup_message_headers_get_one (message->response_headers,
+                                         "Content-Encoding");
+  if (coding != NULL && g_ascii_strcasecmp (coding, "identity") != 0)
+    {
+      GZlibCompressorFormat format;
+
+      if (g_ascii_strcasecmp (coding, "gzip") == 0
+          || g_ascii_strcasecmp (coding, "x-gzip") == 0)
+        format = G_ZLIB_COMPRESSOR_FORMAT_GZIP;
+      else if (g_ascii_strcasecmp (coding, "deflate") == 0)
+        format = G_ZLIB_COMPRESSOR_FORMAT_ZLIB;
+      else
+        return NULL;
+      decoder = G_CONVERTER (g_zlib_decompressor_new (format));
+    }
+
+  converter = _zanata_counting_converter_new (session, decoder);
+  decoded = g_converter_input_stream_new (stream, converter);
+  g_object_unref (converter);
+  g_clear_object (&decoder);
+  return decoded;
+}
+
+static void
+send_cb (GObject      *source_object,
+         GAsyncResult *res,
+         gpointer      user_data)
 {
-  JsonParser *parser = JSON_PARSER (source_object);
+  SoupSession *soup_session = SOUP_SESSION (source_object);
   GTask *task = G_TASK (user_data);
+  ZanataSession *session = g_task_get_source_object (task);
+  SendData *data = g_task_get_task_data (task);
   GError *error = NULL;
-  JsonNode *node;
-  JsonArray *array;
-  GList *suggestions = NULL;
+  GError *body_error;
+  GInputStream *stream;
+  guint status;
+
+  stream = soup_session_send_finish (soup_session, res, &error);
+
+  /* A failure to read the streamed request body takes precedence
+     over whatever the server answered to the truncated body.  */
+  body_error = _zanata_request_take_body_error (data->message);
+  if (body_error)
+    {
+      g_clear_object (&stream);
+      g_clear_error (&error);
+      g_task_return_error (task, body_error);
+      g_object_unref (task);
+      return;
+    }
 
-  if (!json_parser_load_from_stream_finish (parser, res, &error))
+  if (!stream)
     {
+      if (is_transient_error (error) && send_can_retry (task))
+        {
+          g_error_free (error);
+          send_retry_later (task,
+                            compute_retry_delay (session, data->attempt, -1));
+          return;
+        }
+
       g_task_return_error (task, error);
       g_object_unref (task);
       return;
     }
 
-  node = json_parser_get_root (parser);
-  if (json_node_get_node_type (node) != JSON_NODE_ARRAY)
+  status = data->message->status_code;
+  if (status == SOUP_STATUS_UNAUTHORIZED && !data->auth_refreshed
+      && _zanata_request_can_replay (data->request))
+    {
+      g_object_unref (stream);
+      data->auth_refreshed = TRUE;
+      send_refresh_authorization (task);
+      return;
+    }
+
+  if (!SOUP_STATUS_IS_SUCCESSFUL (status)
+      && !(status == SOUP_STATUS_NOT_MODIFIED && !data->unconditional
+           && data->cache_key != NULL && session->cache != NULL))
     {
+      gint64 retry_after = parse_retry_after (data->message->response_headers);
+
+      g_object_unref (stream);
+
+      /* The server is throttling this client; hold back every request
+         to the same domain, not only the retry.  */
+      if (retry_after > 0
+          && (status == 429 || status == SOUP_STATUS_SERVICE_UNAVAILABLE))
+        _zanata_rate_limiter_defer (session->rate_limiter,
+                                    retry_after * 1000);
+
+      if (is_transient_status (status) && send_can_retry (task))
+        {
+          send_retry_later (task,
+                            compute_retry_delay (session,
+                                                 data->attempt,
+                                                 retry_after));
+          return;
+        }
+
       g_task_return_new_error (task,
                                ZANATA_ERROR,
-                               ZANATA_ERROR_INVALID_RESPONSE,
-                               "root element is not an array");
+                               ZANATA_ERROR_HTTP,
+                               "HTTP error %u: %s",
+                               status,
+                               data->message->reason_phrase);
       g_object_unref (task);
       return;
     }
 
-  array = json_node_get_array (node);
-  json_array_foreach_element (array, collect_suggestions, &suggestions);
-  g_task_return_pointer (task, suggestions, (GDestroyNotify) free_suggestions);
+  if (status != SOUP_STATUS_NOT_MODIFIED)
+    {
+      GInputStream *decoded;
+
+      decoded = decode_response_stream (session, data->message, stream);
+      g_object_unref (stream);
+      if (!decoded)
+        {
+          const gchar *coding;
+
+          coding =
+            soup_message_headers_get_one (data->message->response_headers,
+                                          "Content-Encoding");
+          g_task_return_new_error (task,
+                                   ZANATA_ERROR,
+                                   ZANATA_ERROR_INVALID_RESPONSE,
+                                   "Unsupported content coding %s",
+                                   coding);
+          g_object_unref (task);
+          return;
+        }
+      stream = decoded;
+    }
+
+  if (data->cache_key != NULL && session->cache != NULL)
+    {
+      if (data->message->status_code == SOUP_STATUS_NOT_MODIFIED)
+        {
+          GBytes *body = NULL;
+
+          g_object_unref (stream);
+          stream = NULL;
+
+          if (!data->keep_body)
+            data->cached_object =
+              _zanata_cache_get_decoded (session->cache, data->cache_key);
+          if (data->cached_object == NULL)
+            body = _zanata_cache_get_body (session->cache, data->cache_key);
+          if (body != NULL)
+            {
+              stream = g_memory_input_stream_new_from_bytes (body);
+              data->body = body;
+            }
+          else if (data->cached_object == NULL)
+            {
+              /* The body was evicted, or its file removed, after the
+                 validators were sent.  This is not the caller's
+                 problem: fetch the response again.  */
+              _zanata_cache_remove (session->cache, data->cache_key);
+              data->unconditional = TRUE;
+              send_start (task);
+              return;
+            }
+        }
+      else if (SOUP_STATUS_IS_SUCCESSFUL (data->message->status_code))
+        {
+          guint64 serial;
+
+          serial = _zanata_cache_update (session->cache,
+                                         data->cache_key,
+                                         data->message->response_headers,
+                                         NULL);
+
+          /* The body is copied to the cache while the caller reads
+             it, so that it is still streamed.  */
+          if (serial > 0
+              && (data->keep_body
+                  || _zanata_cache_get_persistent (session->cache)))
+            {
+              GConverter *converter;
+              GInputStream *teed;
+
+              converter = _zanata_cache_converter_new (session->cache,
+                                                       data->cache_key,
+                                                       serial,
+                                                       session->cache_memory_size);
+              teed = g_converter_input_stream_new (stream, converter);
+              g_object_unref (converter);
+              g_object_unref (stream);
+              stream = teed;
+            }
+        }
+    }
+
+  g_task_return_pointer (task, stream, g_object_unref);
   g_object_unref (task);
 }
 
+/* Called once the request of TASK has a host slot.  */
 static void
-get_suggestions_invoke_cb (GObject      *source_object,
-                           GAsyncResult *res,
-                           gpointer      user_data)
+send_dispatch (GTask *task)
+{
+  ZanataSession *session = g_task_get_source_object (task);
+  SendData *data = g_task_get_task_data (task);
+  SoupMessage *message;
+  SendSlot *slot;
+  gsize uncompressed;
+
+  if (data->cancel_source)
+    {
+      g_source_destroy (data->cancel_source);
+      g_clear_pointer (&data->cancel_source, g_source_unref);
+    }
+
+  if (g_task_return_error_if_cancelled (task))
+    {
+      g_object_ref (session);
+      send_release (session, data->host);
+      g_object_unref (task);
+      g_object_unref (session);
+      return;
+    }
+
+  data->auth_generation = g_atomic_int_get (&session->auth_generation);
+  message = _zanata_request_build_message (data->request);
+  zanata_authorizer_process_message (session->authorizer,
+                                     session->domain,
+                                     message);
+
+  if (!session->keep_alive)
+    soup_message_headers_append (message->request_headers,
+                                 "Connection", "close");
+
+  soup_message_headers_replace (message->request_headers,
+                                "Accept-Encoding", "gzip, deflate");
+  uncompressed = 0;
+  if (session->compress_threshold > 0)
+    uncompressed = _zanata_request_compress_message (data->request,
+                                                     message,
+                                                     session->compress_threshold);
+  if (uncompressed > 0)
+    {
+      add_sent (session, 0, uncompressed);
+      g_signal_connect_object (message, "wrote-body-data",
+                               G_CALLBACK (send_wrote_compressed_body_data_cb),
+                               session, 0);
+    }
+  else
+    g_signal_connect_object (message, "wrote-body-data",
+                             G_CALLBACK (send_wrote_body_data_cb),
+                             session, 0);
+
+  if (data->cache_key != NULL && session->cache != NULL
+      && !data->unconditional)
+    _zanata_cache_add_validators (session->cache,
+                                  data->cache_key,
+                                  message->request_headers);
+
+  slot = g_slice_new0 (SendSlot);
+  slot->session = g_object_ref (session);
+  slot->host = g_strdup (data->host);
+  g_signal_connect_data (message, "finished",
+                         G_CALLBACK (send_message_finished_cb),
+                         slot, send_slot_free, 0);
+
+  if (data->deadline)
+    send_deadline_set_message (data->deadline, message);
+
+  g_clear_object (&data->message);
+  data->message = message;
+  _zanata_request_set_message_session (message, session->soup_session);
+  soup_session_send_async (session->soup_session,
+                           message,
+                           g_task_get_cancellable (task),
+                           send_cb,
+                           task);
+}
+
+static gboolean
+send_cancelled_cb (GCancellable *cancellable,
+                   gpointer      user_data)
 {
-  ZanataSession *session = ZANATA_SESSION (source_object);
   GTask *task = G_TASK (user_data);
-  JsonParser *parser;
+  ZanataSession *session = g_task_get_source_object (task);
+  SendData *data = g_task_get_task_data (task);
+  HostQueue *queue;
+  gboolean removed;
+
+  g_mutex_lock (&session->scheduler_lock);
+  queue = g_hash_table_lookup (session->hosts, data->host);
+  removed = g_queue_remove (&queue->pending[data->priority], task);
+  g_mutex_unlock (&session->scheduler_lock);
+
+  if (removed)
+    {
+      g_clear_pointer (&data->cancel_source, g_source_unref);
+      g_task_return_error_if_cancelled (task);
+      g_object_unref (task);
+    }
+
+  return G_SOURCE_REMOVE;
+}
+
+static gboolean
+send_rate_limit_cb (gpointer user_data)
+{
+  GTask *task = G_TASK (user_data);
+  ZanataSession *session = g_task_get_source_object (task);
+  SendData *data = g_task_get_task_data (task);
+
+  g_clear_pointer (&data->wait_source, g_source_unref);
+  if (g_task_return_error_if_cancelled (task))
+    {
+      /* The token was never used.  */
+      _zanata_rate_limiter_release (session->rate_limiter);
+      g_object_unref (task);
+      return G_SOURCE_REMOVE;
+    }
+
+  send_start (task);
+  return G_SOURCE_REMOVE;
+}
+
+/* Waits for a token of the rate limiter of the authorization domain,
+   before any host slot is taken so that a throttled request does not
+   hold one back from others.  Then sends the request of TASK right
+   away if its host has a free slot, or queues it behind the requests
+   of the same priority.  */
+static void
+send_start (GTask *task)
+{
+  ZanataSession *session = g_task_get_source_object (task);
+  SendData *data = g_task_get_task_data (task);
+  SoupURI *endpoint = zanata_request_get_endpoint (data->request);
+  HostQueue *queue;
+  GCancellable *cancellable;
+  guint i;
+
+  if (g_task_return_error_if_cancelled (task))
+    {
+      g_object_unref (task);
+      return;
+    }
+
+  if (!data->rate_reserved)
+    {
+      gint64 wait = _zanata_rate_limiter_reserve (session->rate_limiter);
+
+      if (wait > 0)
+        {
+          data->rate_reserved = TRUE;
+          send_wait (task, (wait + 999) / 1000, send_rate_limit_cb);
+          return;
+        }
+    }
+  data->rate_reserved = FALSE;
+
+  g_free (data->host);
+  data->host = g_strdup_printf ("%s:%u",
+                                soup_uri_get_host (endpoint),
+                                soup_uri_get_port (endpoint));
+  data->priority = zanata_request_get_priority (data->request);
+
+  g_mutex_lock (&session->scheduler_lock);
+  queue = g_hash_table_lookup (session->hosts, data->host);
+  if (queue == NULL)
+    {
+      queue = host_queue_new ();
+      g_hash_table_insert (session->hosts, g_strdup (data->host), queue);
+    }
+
+  if (queue->in_flight < session->max_requests_per_host)
+    {
+      for (i = 0; i < G_N_ELEMENTS (queue->pending); i++)
+        if (!g_queue_is_empty (&queue->pending[i]))
+          break;
+
+      if (i == G_N_ELEMENTS (queue->pending))
+        {
+          queue->in_flight++;
+          g_mutex_unlock (&session->scheduler_lock);
+          send_dispatch (task);
+          return;
+        }
+    }
+
+  cancellable = g_task_get_cancellable (task);
+  if (cancellable)
+    {
+      data->cancel_source = g_cancellable_source_new (cancellable);
+      g_source_set_callback (data->cancel_source,
+                             (GSourceFunc) send_cancelled_cb,
+                             task,
+                             NULL);
+      g_source_attach (data->cancel_source,
+                       g_main_context_get_thread_default ());
+    }
+  g_queue_push_tail (&queue->pending[data->priority], task);
+  g_mutex_unlock (&session->scheduler_lock);
+}
+
+/* Frees the slot of a finished request on HOST, and hands it to the
+   oldest queued request of the highest priority.  */
+static void
+send_release (ZanataSession *session,
+              const gchar   *host)
+{
+  HostQueue *queue;
+  GTask *next = NULL;
+  guint i;
+
+  g_mutex_lock (&session->scheduler_lock);
+  queue = g_hash_table_lookup (session->hosts, host);
+  queue->in_flight--;
+  if (queue->in_flight < session->max_requests_per_host)
+    {
+      for (i = 0; i < G_N_ELEMENTS (queue->pending) && next == NULL; i++)
+        next = g_queue_pop_head (&queue->pending[i]);
+      if (next)
+        queue->in_flight++;
+    }
+  g_mutex_unlock (&session->scheduler_lock);
+
+  if (next)
+    send_dispatch (next);
+}
+
+static GTask *
+send_task_new (ZanataSession       *session,
+               ZanataRequest       *request,
+               GCancellable        *cancellable,
+               GAsyncReadyCallback  callback,
+               gpointer             user_data)
+{
+  GTask *task;
+  SendData *data;
+  gint timeout;
+
+  data = g_slice_new0 (SendData);
+  data->request = g_object_ref (request);
+
+  /* Every stage of the operation is run with the cancellable of the
+     deadline, which is also triggered by CANCELLABLE.  */
+  timeout = zanata_request_get_timeout (request);
+  if (timeout < 0)
+    timeout = MIN (session->timeout, G_MAXINT);
+  if (timeout > 0)
+    {
+      data->deadline = send_deadline_new (session, cancellable, timeout);
+      cancellable = data->deadline->cancellable;
+    }
+
+  task = g_task_new (session, cancellable, callback, user_data);
+  g_task_set_task_data (task, data, (GDestroyNotify) send_data_free);
+  return task;
+}
+
+/**
+ * zanata_session_send:
+ * @session: a #ZanataSession
+ * @request: a #ZanataRequest
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: a #GAsyncReadyCallback
+ * @user_data: (nullable): a user data
+ *
+ * Starts sending @request over the connection pool owned by
+ * @session.  Query parameters, headers and the request body are
+ * handled the same way regardless of the HTTP method, and the
+ * response body is always streamed.  This operation is asynchronous
+ * and shall be finished with zanata_session_send_finish().
+ */
+void
+zanata_session_send (ZanataSession       *session,
+                     ZanataRequest       *request,
+                     GCancellable        *cancellable,
+                     GAsyncReadyCallback  callback,
+                     gpointer             user_data)
+{
+  GTask *task;
+
+  g_return_if_fail (ZANATA_IS_SESSION (session));
+  g_return_if_fail (ZANATA_IS_REQUEST (request));
+
+  task = send_task_new (session, request, cancellable, callback, user_data);
+  send_start (task);
+}
+
+/* Like zanata_session_send(), but revalidates the response with the
+   conditional-request cache when it is enabled.  With KEEP_BODY, the
+   response body itself is cached, for responses which are not
+   decoded into objects.  */
+void
+_zanata_session_send_cached (ZanataSession       *session,
+                             ZanataRequest       *request,
+                             gboolean             keep_body,
+                             GCancellable        *cancellable,
+                             GAsyncReadyCallback  callback,
+                             gpointer             user_data)
+{
+  GTask *task;
+  SendData *data;
+
+  task = send_task_new (session, request, cancellable, callback, user_data);
+  data = g_task_get_task_data (task);
+  if (session->cache != NULL)
+    {
+      SoupMessage *message = _zanata_request_build_message (request);
+
+      data->cache_key = soup_uri_to_string (soup_message_get_uri (message),
+                                            FALSE);
+      data->keep_body = keep_body;
+      g_object_unref (message);
+    }
+  send_start (task);
+}
+
+/* Returns the response body, which may come from the cache.  If the
+   response was not modified and the object decoded from it is still
+   cached, NULL is returned without an error and the object is set in
+   CACHED_OBJECT instead.  */
+GInputStream *
+_zanata_session_send_cached_finish (ZanataSession  *session,
+                                    GAsyncResult   *result,
+                                    gchar         **cache_key,
+                                    GObject       **cached_object,
+                                    GError        **error)
+{
+  SendData *data;
+  GInputStream *stream;
+
+  g_return_val_if_fail (g_task_is_valid (result, session), NULL);
+
+  data = g_task_get_task_data (G_TASK (result));
+  *cache_key = g_strdup (data->cache_key);
+  *cached_object = NULL;
+  stream = g_task_propagate_pointer (G_TASK (result), error);
+  if (!stream && data->cached_object)
+    *cached_object = g_steal_pointer (&data->cached_object);
+  if (!stream)
+    send_deadline_check_error (data->deadline, error);
+  return stream;
+}
+
+void
+_zanata_session_set_cached_object (ZanataSession *session,
+                                   const gchar   *cache_key,
+                                   GObject       *object)
+{
+  if (cache_key == NULL || session->cache == NULL)
+    return;
+
+  _zanata_cache_set_decoded (session->cache, cache_key, object);
+}
+
+/**
+ * zanata_session_send_finish:
+ * @session: a #ZanataSession
+ * @result: a #GAsyncResult
+ * @error: error location
+ *
+ * Finishes zanata_session_send() operation.
+ *
+ * Returns: (transfer full): a #GInputStream of the response body
+ */
+GInputStream *
+zanata_session_send_finish (ZanataSession  *session,
+                            GAsyncResult   *result,
+                            GError        **error)
+{
+  SendData *data;
+  GInputStream *stream;
+
+  g_return_val_if_fail (g_task_is_valid (result, session), NULL);
+
+  data = g_task_get_task_data (G_TASK (result));
+  stream = g_task_propagate_pointer (G_TASK (result), error);
+  if (!stream)
+    send_deadline_check_error (data->deadline, error);
+  return stream;
+}
+
+/**
+ * zanata_session_invoke:
+ * @session: a #ZanataSession
+ * @method: a string
+ * @endpoint: a #SoupURI
+ * @parameters: (nullable): (array zero-terminated=1) (element-type ZanataParameter): an array of parameters
+ * @request_content_type: (nullable): a string
+ * @request: (nullable): a string
+ * @request_length: the length of request or -1
+ * @response_content_type: (nullable): a string
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: a #GAsyncReadyCallback
+ * @user_data: (nullable): a user data
+ *
+ * Starts invoking a REST call.  This operation is asynchronous and
+ * shall be finished with zanata_session_invoke_finish().
+ *
+ * This is a convenience wrapper around zanata_session_send().
+ */
+void
+zanata_session_invoke (ZanataSession       *session,
+                       const gchar         *method,
+                       SoupURI             *endpoint,
+                       ZanataParameter    **parameters,
+                       const gchar         *request_content_type,
+                       const gchar         *request,
+                       gsize                request_length,
+                       const gchar         *response_content_type,
+                       GCancellable        *cancellable,
+                       GAsyncReadyCallback  callback,
+                       gpointer             user_data)
+{
+  ZanataRequest *zrequest;
+
+  zrequest = zanata_request_new (method, endpoint);
+  if (parameters != NULL)
+    {
+      while (*parameters)
+        {
+          zanata_request_add_parameter (zrequest,
+                                        (*parameters)->name,
+                                        (*parameters)->value);
+          parameters++;
+        }
+    }
+  if (request != NULL)
+    zanata_request_set_body (zrequest,
+                             request_content_type,
+                             request,
+                             (gssize) request_length);
+  zanata_request_set_accept (zrequest, response_content_type);
+
+  zanata_session_send (session, zrequest, cancellable, callback, user_data);
+  g_object_unref (zrequest);
+}
+
+/**
+ * zanata_session_invoke_finish:
+ * @session: a #ZanataSession
+ * @result: a #GAsyncResult
+ * @error: error location
+ *
+ * Finishes zanata_session_invoke() operation.
+ *
+ * Returns: (transfer full): a #GInputStream.
+ */
+GInputStream *
+zanata_session_invoke_finish (ZanataSession  *session,
+                              GAsyncResult   *result,
+                              GError        **error)
+{
+  return zanata_session_send_finish (session, result, error);
+}
+
+/* Reads the whole response body of a send operation into one
+   contiguous buffer.  If the body is already held in memory, it is
+   returned as is; otherwise the buffer is sized from the
+   Content-Length of the response, if any, so that it is not
+   reallocated while reading.  */
+
+#define READ_BODY_CHUNK_SIZE (16 * 1024)
+
+/* The most which is allocated up front from the Content-Length of a
+   response, which the server may not honour; larger bodies grow the
+   buffer as they arrive.  */
+#define READ_BODY_MAX_PREALLOC (4 * 1024 * 1024)
+
+typedef struct _ReadBodyData ReadBodyData;
+
+struct _ReadBodyData
+{
+  SendDeadline *deadline;
+  GInputStream *stream;
+  GByteArray *buffer;
+  gsize expected;
+  gboolean expected_exact;
+  guint offset;
+};
+
+static void
+read_body_data_free (ReadBodyData *data)
+{
+  g_clear_pointer (&data->deadline, send_deadline_unref);
+  g_object_unref (data->stream);
+  g_clear_pointer (&data->buffer, g_byte_array_unref);
+  g_slice_free (ReadBodyData, data);
+}
+
+static void read_body_next (GTask *task);
+
+static void
+read_body_cb (GObject      *source_object,
+              GAsyncResult *res,
+              gpointer      user_data)
+{
+  GTask *task = G_TASK (user_data);
+  ReadBodyData *data = g_task_get_task_data (task);
+  GError *error = NULL;
+  gssize nread;
+
+  nread = g_input_stream_read_finish (data->stream, res, &error);
+  if (nread < 0)
+    {
+      send_deadline_check_error (data->deadline, &error);
+      g_task_return_error (task, error);
+      g_object_unref (task);
+      return;
+    }
+
+  g_byte_array_set_size (data->buffer, data->offset + nread);
+  if (nread == 0)
+    {
+      GBytes *body = g_byte_array_free_to_bytes (data->buffer);
+
+      data->buffer = NULL;
+      g_task_return_pointer (task, body, (GDestroyNotify) g_bytes_unref);
+      g_object_unref (task);
+      return;
+    }
+
+  read_body_next (task);
+}
+
+static void
+read_body_next (GTask *task)
+{
+  ReadBodyData *data = g_task_get_task_data (task);
+  gsize size = READ_BODY_CHUNK_SIZE;
+
+  /* Read the rest of the announced body at once, then probe for the
+     end of the stream within the spare byte reserved for it.  */
+  if (data->expected > data->buffer->len)
+    size = data->expected - data->buffer->len;
+  else if (data->expected_exact && data->expected > 0
+           && data->expected == data->buffer->len)
+    size = 1;
+
+  data->offset = data->buffer->len;
+  g_byte_array_set_size (data->buffer, data->offset + size);
+  g_input_stream_read_async (data->stream,
+                             data->buffer->data + data->offset,
+                             size,
+                             G_PRIORITY_DEFAULT,
+                             data->deadline
+                             ? data->deadline->cancellable
+                             : g_task_get_cancellable (task),
+                             read_body_cb,
+                             task);
+}
+
+static void
+read_body_async (ZanataSession       *session,
+                 GAsyncResult        *send_result,
+                 GInputStream        *stream,
+                 GCancellable        *cancellable,
+                 GAsyncReadyCallback  callback,
+                 gpointer             user_data)
+{
+  SendData *send_data = g_task_get_task_data (G_TASK (send_result));
+  GTask *task;
+  ReadBodyData *data;
+  SoupMessageHeaders *headers;
+
+  task = g_task_new (session, cancellable, callback, user_data);
+  if (send_data->body != NULL)
+    {
+      g_task_return_pointer (task,
+                             g_bytes_ref (send_data->body),
+                             (GDestroyNotify) g_bytes_unref);
+      g_object_unref (task);
+      return;
+    }
+
+  data = g_slice_new0 (ReadBodyData);
+  if (send_data->deadline)
+    data->deadline = send_deadline_ref (send_data->deadline);
+  data->stream = g_object_ref (stream);
+  headers = send_data->message->response_headers;
+  /* The announced length is that of the encoded body, which is of no
+     use to size the decoded one.  */
+  if (soup_message_headers_get_encoding (headers)
+      == SOUP_ENCODING_CONTENT_LENGTH
+      && soup_message_headers_get_one (headers, "Content-Encoding") == NULL)
+    {
+      goffset length = soup_message_headers_get_content_length (headers);
+
+      data->expected = MIN (length, READ_BODY_MAX_PREALLOC);
+      data->expected_exact = data->expected == (gsize) length;
+    }
+  data->buffer = g_byte_array_sized_new (data->expected > 0
+                                         ? data->expected + 1
+                                         : READ_BODY_CHUNK_SIZE);
+  g_task_set_task_data (task, data, (GDestroyNotify) read_body_data_free);
+  read_body_next (task);
+}
+
+static GBytes *
+read_body_finish (ZanataSession  *session,
+                  GAsyncResult   *result,
+                  GError        **error)
+{
+  g_return_val_if_fail (g_task_is_valid (result, session), NULL);
+
+  return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+static void
+invoke_bytes_read_cb (GObject      *source_object,
+                      GAsyncResult *res,
+                      gpointer      user_data)
+{
+  ZanataSession *session = ZANATA_SESSION (source_object);
+  GTask *task = G_TASK (user_data);
+  GError *error = NULL;
+  GBytes *body;
+
+  body = read_body_finish (session, res, &error);
+  if (!body)
+    g_task_return_error (task, error);
+  else
+    g_task_return_pointer (task, body, (GDestroyNotify) g_bytes_unref);
+  g_object_unref (task);
+}
+
+static void
+invoke_bytes_send_cb (GObject      *source_object,
+                      GAsyncResult *res,
+                      gpointer      user_data)
+{
+  ZanataSession *session = ZANATA_SESSION (source_object);
+  GTask *task = G_TASK (user_data);
+  GError *error = NULL;
+  GInputStream *stream;
+
+  stream = zanata_session_send_finish (session, res, &error);
+  if (!stream)
+    {
+      g_task_return_error (task, error);
+      g_object_unref (task);
+      return;
+    }
+
+  read_body_async (session,
+                   res,
+                   stream,
+                   g_task_get_cancellable (task),
+                   invoke_bytes_read_cb,
+                   task);
+  g_object_unref (stream);
+}
+
+/**
+ * zanata_session_invoke_bytes:
+ * @session: a #ZanataSession
+ * @method: an HTTP method
+ * @endpoint: a #SoupURI
+ * @parameters: (nullable): (array zero-terminated=1) (element-type ZanataParameter): an array of parameters
+ * @request_content_type: (nullable): a string
+ * @request: (nullable): the request body
+ * @response_content_type: (nullable): a string
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: a #GAsyncReadyCallback
+ * @user_data: (nullable): a user data
+ *
+ * Starts invoking a REST call, like zanata_session_invoke(), but
+ * sends @request without copying it and delivers the whole response
+ * body as a #GBytes.  This operation is asynchronous and shall be
+ * finished with zanata_session_invoke_bytes_finish().
+ */
+void
+zanata_session_invoke_bytes (ZanataSession       *session,
+                             const gchar         *method,
+                             SoupURI             *endpoint,
+                             ZanataParameter    **parameters,
+                             const gchar         *request_content_type,
+                             GBytes              *request,
+                             const gchar         *response_content_type,
+                             GCancellable        *cancellable,
+                             GAsyncReadyCallback  callback,
+                             gpointer             user_data)
+{
+  GTask *task;
+  ZanataRequest *zrequest;
+
+  task = g_task_new (session, cancellable, callback, user_data);
+
+  zrequest = zanata_request_new (method, endpoint);
+  if (parameters != NULL)
+    {
+      while (*parameters)
+        {
+          zanata_request_add_parameter (zrequest,
+                                        (*parameters)->name,
+                                        (*parameters)->value);
+          parameters++;
+        }
+    }
+  if (request != NULL)
+    zanata_request_set_body_bytes (zrequest, request_content_type, request);
+  zanata_request_set_accept (zrequest, response_content_type);
+
+  zanata_session_send (session, zrequest, cancellable,
+                       invoke_bytes_send_cb, task);
+  g_object_unref (zrequest);
+}
+
+/**
+ * zanata_session_invoke_bytes_finish:
+ * @session: a #ZanataSession
+ * @result: a #GAsyncResult
+ * @error: error location
+ *
+ * Finishes zanata_session_invoke_bytes() operation.
+ *
+ * Returns: (transfer full): the response body
+ */
+GBytes *
+zanata_session_invoke_bytes_finish (ZanataSession  *session,
+                                    GAsyncResult   *result,
+                                    GError        **error)
+{
+  g_return_val_if_fail (g_task_is_valid (result, session), NULL);
+
+  return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+/* Response bodies are read into memory and decoded by a DecodeFunc,
+   either inline or, when larger than the decode threshold, by the
+   decode pool.  The result is delivered in the caller's context
+   either way.  */
+
+typedef GObject *(*DecodeFunc) (ZanataSession  *session,
+                                JsonNode       *root,
+                                GError        **error);
+
+typedef struct _DecodeJob DecodeJob;
+
+struct _DecodeJob
+{
+  DecodeFunc func;
+  GBytes *body;
+};
+
+static void
+decode_job_free (DecodeJob *job)
+{
+  g_clear_pointer (&job->body, g_bytes_unref);
+  g_slice_free (DecodeJob, job);
+}
+
+static void
+decode_job_execute (GTask *task)
+{
+  ZanataSession *session = g_task_get_source_object (task);
+  DecodeJob *job = g_task_get_task_data (task);
+  JsonParser *parser;
+  GError *error = NULL;
+  GObject *result = NULL;
+  gconstpointer data;
+  gsize size;
+
+  if (g_task_return_error_if_cancelled (task))
+    return;
+
+  data = g_bytes_get_data (job->body, &size);
+  parser = json_parser_new ();
+  if (json_parser_load_from_data (parser, data, size, &error)
+      && !g_cancellable_set_error_if_cancelled (g_task_get_cancellable (task),
+                                                &error))
+    result = job->func (session, json_parser_get_root (parser), &error);
+  g_object_unref (parser);
+
+  if (result)
+    g_task_return_pointer (task, result, g_object_unref);
+  else
+    g_task_return_error (task, error);
+}
+
+static void
+decode_job_run (gpointer data,
+                gpointer user_data)
+{
+  GTask *task = data;
+
+  decode_job_execute (task);
+  g_object_unref (task);
+}
+
+static void
+decode_read_cb (GObject      *source_object,
+                GAsyncResult *res,
+                gpointer      user_data)
+{
+  ZanataSession *session = ZANATA_SESSION (source_object);
+  GTask *task = G_TASK (user_data);
+  DecodeJob *job = g_task_get_task_data (task);
+  GError *error = NULL;
+
+  job->body = read_body_finish (session, res, &error);
+  if (!job->body)
+    {
+      g_task_return_error (task, error);
+      g_object_unref (task);
+      return;
+    }
+
+  if (session->decode_threads > 0
+      && g_bytes_get_size (job->body) >= session->decode_threshold)
+    {
+      /* The pool takes over the reference on the task.  */
+      g_thread_pool_push (session->decode_pool, task, NULL);
+      return;
+    }
+
+  decode_job_execute (task);
+  g_object_unref (task);
+}
+
+/* Decodes the response body of SEND_RESULT, whose stream is STREAM,
+   with FUNC.  */
+static void
+decode_json_async (ZanataSession       *session,
+                   GAsyncResult        *send_result,
+                   GInputStream        *stream,
+                   DecodeFunc           func,
+                   GCancellable        *cancellable,
+                   GAsyncReadyCallback  callback,
+                   gpointer             user_data)
+{
+  GTask *task;
+  DecodeJob *job;
+
+  task = g_task_new (session, cancellable, callback, user_data);
+  job = g_slice_new0 (DecodeJob);
+  job->func = func;
+  g_task_set_task_data (task, job, (GDestroyNotify) decode_job_free);
+
+  read_body_async (session,
+                   send_result,
+                   stream,
+                   cancellable,
+                   decode_read_cb,
+                   task);
+}
+
+static GObject *
+decode_json_finish (ZanataSession  *session,
+                    GAsyncResult   *result,
+                    GError        **error)
+{
+  g_return_val_if_fail (g_task_is_valid (result, session), NULL);
+
+  return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+static GObject *
+decode_suggestions (ZanataSession  *session,
+                    JsonNode       *root,
+                    GError        **error)
+{
+  if (json_node_get_node_type (root) != JSON_NODE_ARRAY)
+    {
+      g_set_error_literal (error,
+                           ZANATA_ERROR,
+                           ZANATA_ERROR_INVALID_RESPONSE,
+                           "root element is not an array");
+      return NULL;
+    }
+
+  return G_OBJECT (_zanata_suggestion_list_new_from_array (json_node_get_array (root)));
+}
+
+static void
+get_suggestions_load_cb (GObject      *source_object,
+                         GAsyncResult *res,
+                         gpointer      user_data)
+{
+  ZanataSession *session = ZANATA_SESSION (source_object);
+  GTask *task = G_TASK (user_data);
+  GError *error = NULL;
+  GObject *model;
+
+  model = decode_json_finish (session, res, &error);
+  if (!model)
+    {
+      g_task_return_error (task, error);
+      g_object_unref (task);
+      return;
+    }
+
+  _zanata_suggestion_cache_insert (session->suggestion_cache,
+                                   g_task_get_task_data (task),
+                                   G_LIST_MODEL (model));
+  g_task_return_pointer (task, model, g_object_unref);
+  g_object_unref (task);
+}
+
+static void
+get_suggestions_invoke_cb (GObject      *source_object,
+                           GAsyncResult *res,
+                           gpointer      user_data)
+{
+  ZanataSession *session = ZANATA_SESSION (source_object);
+  GTask *task = G_TASK (user_data);
+  GError *error = NULL;
+  GInputStream *stream;
+
+  stream = zanata_session_send_finish (session, res, &error);
+  if (!stream)
+    {
+      g_task_return_error (task, error);
+      g_object_unref (task);
+      return;
+    }
+
+  decode_json_async (session,
+                     res,
+                     stream,
+                     decode_suggestions,
+                     g_task_get_cancellable (task),
+                     get_suggestions_load_cb,
+                     task);
+  g_object_unref (stream);
+}
+
+static void
+fetch_suggestions (ZanataSession       *session,
+                   const gchar * const *query,
+                   const gchar         *from_locale,
+                   const gchar         *to_locale,
+                   gchar               *key,
+                   GCancellable        *cancellable,
+                   GAsyncReadyCallback  callback,
+                   gpointer             user_data)
+{
+  GTask *task;
+  SoupURI *uri;
+  ZanataRequest *request;
+  JsonBuilder *builder;
+  JsonGenerator *generator;
+  gchar *data;
+  gsize data_length;
+
+  task = g_task_new (session, cancellable, callback, user_data);
+  g_task_set_task_data (task, key, g_free);
+
+  builder = json_builder_new ();
+  json_builder_begin_array (builder);
+  while (*query)
+    {
+      json_builder_add_string_value (builder, *query);
+      query++;
+    }
+  json_builder_end_array (builder);
+
+  generator = json_generator_new ();
+  json_generator_set_root (generator, json_builder_get_root (builder));
+  g_object_unref (builder);
+  data = json_generator_to_data (generator, &data_length);
+  g_object_unref (generator);
+
+  uri = _zanata_session_build_endpoint (session,
+                                        ZANATA_ENDPOINT_SUGGESTIONS,
+                                        NULL);
+
+  request = zanata_request_new ("POST", uri);
+  soup_uri_free (uri);
+  zanata_request_add_parameter (request, "from", from_locale);
+  zanata_request_add_parameter (request, "to", to_locale);
+  zanata_request_set_body (request, "application/json", data, data_length);
+  zanata_request_set_accept (request, "application/json");
+  /* The lookup does not modify anything on the server.  */
+  zanata_request_set_idempotent (request, TRUE);
+  g_free (data);
+
+  zanata_session_send (session,
+                       request,
+                       cancellable,
+                       get_suggestions_invoke_cb,
+                       task);
+  g_object_unref (request);
+}
+
+/* Identical suggestion lookups issued within the batch window share a
+   single request.  Each caller keeps its own GTask, which is completed
+   early if its cancellable is triggered; the shared request is only
+   cancelled once no caller is left.  Callers may run in different
+   threads, so batches and their waiters are only modified with
+   suggestion_batches_lock held, and whichever removes a waiter from
+   its batch completes it.  */
+
+typedef struct _SuggestionBatch SuggestionBatch;
+typedef struct _SuggestionWaiter SuggestionWaiter;
+
+struct _SuggestionBatch
+{
+  gint ref_count;
+  ZanataSession *session;
+  gchar *key;
+  gchar **query;
+  gchar *from_locale;
+  gchar *to_locale;
+
+  GQueue waiters;
+  GSource *timeout_source;
+  GCancellable *cancellable;
+  gboolean sent;
+};
+
+struct _SuggestionWaiter
+{
+  gint ref_count;
+  SuggestionBatch *batch;
+  GTask *task;
+  GSource *cancel_source;
+};
+
+static SuggestionBatch *
+suggestion_batch_ref (SuggestionBatch *batch)
+{
+  g_atomic_int_inc (&batch->ref_count);
+  return batch;
+}
+
+static void
+suggestion_batch_unref (SuggestionBatch *batch)
+{
+  if (!g_atomic_int_dec_and_test (&batch->ref_count))
+    return;
+
+  g_object_unref (batch->session);
+  g_free (batch->key);
+  g_strfreev (batch->query);
+  g_free (batch->from_locale);
+  g_free (batch->to_locale);
+  g_object_unref (batch->cancellable);
+  g_slice_free (SuggestionBatch, batch);
+}
+
+/* Must be called with suggestion_batches_lock held.  */
+static void
+suggestion_batch_detach (SuggestionBatch *batch)
+{
+  ZanataSession *session = batch->session;
+
+  if (g_hash_table_lookup (session->suggestion_batches, batch->key) == batch)
+    g_hash_table_remove (session->suggestion_batches, batch->key);
+}
+
+/* Must be called with suggestion_batches_lock held.  */
+static void
+suggestion_batch_stop_timeout (SuggestionBatch *batch)
+{
+  if (batch->timeout_source)
+    {
+      g_source_destroy (batch->timeout_source);
+      g_clear_pointer (&batch->timeout_source, g_source_unref);
+    }
+}
+
+static SuggestionWaiter *
+suggestion_waiter_ref (SuggestionWaiter *waiter)
+{
+  g_atomic_int_inc (&waiter->ref_count);
+  return waiter;
+}
+
+static void
+suggestion_waiter_unref (SuggestionWaiter *waiter)
+{
+  if (!g_atomic_int_dec_and_test (&waiter->ref_count))
+    return;
+
+  suggestion_batch_unref (waiter->batch);
+  g_object_unref (waiter->task);
+  g_slice_free (SuggestionWaiter, waiter);
+}
+
+/* Detaches WAITER from its cancellable and drops the reference held
+   by the batch.  */
+static void
+suggestion_waiter_release (SuggestionWaiter *waiter)
+{
+  if (waiter->cancel_source)
+    {
+      g_source_destroy (waiter->cancel_source);
+      g_clear_pointer (&waiter->cancel_source, g_source_unref);
+    }
+  suggestion_waiter_unref (waiter);
+}
+
+static void
+suggestion_batch_fetch_cb (GObject      *source_object,
+                           GAsyncResult *res,
+                           gpointer      user_data)
+{
+  ZanataSession *session = ZANATA_SESSION (source_object);
+  SuggestionBatch *batch = user_data;
+  SuggestionWaiter *waiter;
+  GListModel *model;
+  GError *error = NULL;
+  GQueue waiters;
+
+  model = zanata_session_get_suggestions_finish_model (session, res, &error);
+
+  g_mutex_lock (&session->suggestion_batches_lock);
+  suggestion_batch_detach (batch);
+  waiters = batch->waiters;
+  g_queue_init (&batch->waiters);
+  g_mutex_unlock (&session->suggestion_batches_lock);
+
+  while ((waiter = g_queue_pop_head (&waiters)) != NULL)
+    {
+      if (model)
+        g_task_return_pointer (waiter->task,
+                               g_object_ref (model),
+                               g_object_unref);
+      else
+        g_task_return_error (waiter->task, g_error_copy (error));
+      suggestion_waiter_release (waiter);
+    }
+
+  g_clear_object (&model);
+  g_clear_error (&error);
+  suggestion_batch_unref (batch);
+}
+
+/* Sends the shared request.  The batch must have been marked as sent
+   with the lock held.  */
+static void
+suggestion_batch_send (SuggestionBatch *batch)
+{
+  fetch_suggestions (batch->session,
+                     (const gchar * const *) batch->query,
+                     batch->from_locale,
+                     batch->to_locale,
+                     g_strdup (batch->key),
+                     batch->cancellable,
+                     suggestion_batch_fetch_cb,
+                     batch);
+}
+
+static gboolean
+suggestion_batch_timeout_cb (gpointer user_data)
+{
+  SuggestionBatch *batch = user_data;
+  ZanataSession *session = batch->session;
+  gboolean send = FALSE;
+
+  /* The batch may have been flushed or abandoned in another thread
+     since the timeout was dispatched.  */
+  g_mutex_lock (&session->suggestion_batches_lock);
+  if (batch->timeout_source != NULL && !batch->sent)
+    {
+      g_clear_pointer (&batch->timeout_source, g_source_unref);
+      batch->sent = send = TRUE;
+    }
+  g_mutex_unlock (&session->suggestion_batches_lock);
+
+  if (send)
+    suggestion_batch_send (batch);
+  return G_SOURCE_REMOVE;
+}
+
+static gboolean
+suggestion_waiter_cancelled_cb (GCancellable *cancellable,
+                                gpointer      user_data)
+{
+  SuggestionWaiter *waiter = user_data;
+  SuggestionBatch *batch = waiter->batch;
+  ZanataSession *session = batch->session;
+  gboolean removed, abandon = FALSE, cancel = FALSE;
+
+  g_mutex_lock (&session->suggestion_batches_lock);
+  removed = g_queue_remove (&batch->waiters, waiter);
+  if (removed && g_queue_is_empty (&batch->waiters))
+    {
+      suggestion_batch_detach (batch);
+      if (batch->sent)
+        cancel = TRUE;
+      else
+        {
+          suggestion_batch_stop_timeout (batch);
+          batch->sent = abandon = TRUE;
+        }
+    }
+  g_mutex_unlock (&session->suggestion_batches_lock);
+
+  if (removed)
+    {
+      g_task_return_error_if_cancelled (waiter->task);
+      suggestion_waiter_release (waiter);
+    }
+
+  /* A sent batch is released by suggestion_batch_fetch_cb().  */
+  if (cancel)
+    g_cancellable_cancel (batch->cancellable);
+  else if (abandon)
+    suggestion_batch_unref (batch);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+suggestion_batch_add (ZanataSession       *session,
+                      const gchar * const *query,
+                      const gchar         *from_locale,
+                      const gchar         *to_locale,
+                      gchar               *key,
+                      GTask               *task)
+{
+  SuggestionBatch *batch;
+  SuggestionWaiter *waiter;
+  GCancellable *cancellable;
+  gboolean send = FALSE;
+
+  g_mutex_lock (&session->suggestion_batches_lock);
+  batch = g_hash_table_lookup (session->suggestion_batches, key);
+  if (batch == NULL)
+    {
+      /* The reference is released once the shared request has
+         completed, or once every waiter has been cancelled before it
+         is sent.  */
+      batch = g_slice_new0 (SuggestionBatch);
+      batch->ref_count = 1;
+      batch->session = g_object_ref (session);
+      batch->key = key;
+      batch->query = g_strdupv ((gchar **) query);
+      batch->from_locale = g_strdup (from_locale);
+      batch->to_locale = g_strdup (to_locale);
+      batch->cancellable = g_cancellable_new ();
+      g_queue_init (&batch->waiters);
+      /* The window runs in the caller's context, like the cancel
+         sources of the waiters.  */
+      batch->timeout_source =
+        g_timeout_source_new (session->suggestion_batch_window);
+      g_source_set_callback (batch->timeout_source,
+                             suggestion_batch_timeout_cb,
+                             suggestion_batch_ref (batch),
+                             (GDestroyNotify) suggestion_batch_unref);
+      g_source_attach (batch->timeout_source,
+                       g_main_context_get_thread_default ());
+      g_hash_table_insert (session->suggestion_batches, batch->key, batch);
+    }
+  else
+    g_free (key);
+
+  waiter = g_slice_new0 (SuggestionWaiter);
+  waiter->ref_count = 1;
+  waiter->batch = suggestion_batch_ref (batch);
+  waiter->task = task;
+  cancellable = g_task_get_cancellable (task);
+  if (cancellable)
+    {
+      waiter->cancel_source = g_cancellable_source_new (cancellable);
+      g_source_set_callback (waiter->cancel_source,
+                             (GSourceFunc) suggestion_waiter_cancelled_cb,
+                             suggestion_waiter_ref (waiter),
+                             (GDestroyNotify) suggestion_waiter_unref);
+      g_source_attach (waiter->cancel_source,
+                       g_main_context_get_thread_default ());
+    }
+  g_queue_push_tail (&batch->waiters, waiter);
+
+  if (!batch->sent
+      && g_queue_get_length (&batch->waiters) >= session->suggestion_batch_size)
+    {
+      suggestion_batch_stop_timeout (batch);
+      batch->sent = send = TRUE;
+    }
+  g_mutex_unlock (&session->suggestion_batches_lock);
+
+  if (send)
+    suggestion_batch_send (batch);
+}
+
+/**
+ * zanata_session_get_suggestions:
+ * @session: a #ZanataSession
+ * @query: (array zero-terminated=1) (element-type utf8): an array of
+ *   query strings
+ * @from_locale: a locale id of source contents
+ * @to_locale: a locale id of target contents
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: a #GAsyncReadyCallback
+ * @user_data: (nullable): a user data
+ *
+ * Starts retrieving suggestions matching @query.  Recent lookups are
+ * answered from an in-memory cache, bounded by
+ * #ZanataSession:suggestion-cache-size and
+ * #ZanataSession:suggestion-cache-ttl.  If
+ * #ZanataSession:suggestion-batch-window is set, identical lookups
+ * issued within the window are sent as a single request.  This
+ * operation is asynchronous and shall be finished with
+ * zanata_session_get_suggestions_finish().
+ */
+void
+zanata_session_get_suggestions (ZanataSession       *session,
+                                const gchar * const *query,
+                                const gchar         *from_locale,
+                                const gchar         *to_locale,
+                                GCancellable        *cancellable,
+                                GAsyncReadyCallback  callback,
+                                gpointer             user_data)
+{
+  GTask *task;
+  GListModel *cached;
+  gchar *key;
+
+  key = _zanata_suggestion_cache_build_key (query, from_locale, to_locale);
+  cached = _zanata_suggestion_cache_lookup (session->suggestion_cache, key);
+  if (cached)
+    {
+      g_free (key);
+      task = g_task_new (session, cancellable, callback, user_data);
+      g_task_return_pointer (task, cached, g_object_unref);
+      g_object_unref (task);
+      return;
+    }
+
+  if (session->suggestion_batch_window == 0)
+    {
+      fetch_suggestions (session, query, from_locale, to_locale, key,
+                         cancellable, callback, user_data);
+      return;
+    }
+
+  task = g_task_new (session, cancellable, callback, user_data);
+  suggestion_batch_add (session, query, from_locale, to_locale, key, task);
+}
+
+/**
+ * zanata_session_get_suggestions_finish:
+ * @session: a #ZanataSession
+ * @result: a #GAsyncResult
+ * @error: error location
+ *
+ * Finishes zanata_session_get_suggestions() operation.
+ *
+ * Returns: (transfer full) (element-type ZanataSuggestion): a list of
+ * suggestions
+ */
+GList *
+zanata_session_get_suggestions_finish (ZanataSession  *session,
+                                       GAsyncResult   *result,
+                                       GError        **error)
+{
+  GListModel *model;
+  GList *suggestions;
+
+  model = zanata_session_get_suggestions_finish_model (session, result, error);
+  if (!model)
+    return NULL;
+
+  suggestions = _zanata_list_model_to_list (model);
+  g_object_unref (model);
+  return suggestions;
+}
+
+/**
+ * zanata_session_get_suggestions_finish_model:
+ * @session: a #ZanataSession
+ * @result: a #GAsyncResult
+ * @error: error location
+ *
+ * Finishes zanata_session_get_suggestions() operation, like
+ * zanata_session_get_suggestions_finish(), but returns the suggestions
+ * as a #GListModel.
+ *
+ * Returns: (transfer full): a #GListModel of #ZanataSuggestion
+ */
+GListModel *
+zanata_session_get_suggestions_finish_model (ZanataSession  *session,
+                                             GAsyncResult   *result,
+                                             GError        **error)
+{
+  g_return_val_if_fail (g_task_is_valid (result, session), NULL);
+  return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+/**
+ * zanata_session_get_suggestion_cache_stats:
+ * @session: a #ZanataSession
+ * @hits: (out) (optional): return location for the number of lookups
+ *   answered from the cache
+ * @misses: (out) (optional): return location for the number of lookups
+ *   sent to the server
+ *
+ * Retrieves the counters of the suggestion cache, which can be used to
+ * tune #ZanataSession:suggestion-cache-size.
+ */
+void
+zanata_session_get_suggestion_cache_stats (ZanataSession *session,
+                                           guint         *hits,
+                                           guint         *misses)
+{
+  g_return_if_fail (ZANATA_IS_SESSION (session));
+
+  _zanata_suggestion_cache_get_stats (session->suggestion_cache,
+                                      hits, misses);
+}
+
+/**
+ * zanata_session_get_transfer_stats:
+ * @session: a #ZanataSession
+ * @bytes_sent: (out) (optional): return location for the number of
+ *   request body bytes sent
+ * @bytes_sent_uncompressed: (out) (optional): return location for the
+ *   number of request body bytes before compression
+ * @bytes_received: (out) (optional): return location for the number of
+ *   response body bytes received
+ * @bytes_received_decoded: (out) (optional): return location for the
+ *   number of response body bytes after decoding
+ *
+ * Retrieves the transfer counters of @session, which show the savings
+ * of response compression and of #ZanataSession:compress-threshold.
+ */
+void
+zanata_session_get_transfer_stats (ZanataSession *session,
+                                   guint64       *bytes_sent,
+                                   guint64       *bytes_sent_uncompressed,
+                                   guint64       *bytes_received,
+                                   guint64       *bytes_received_decoded)
+{
+  g_return_if_fail (ZANATA_IS_SESSION (session));
+
+  g_mutex_lock (&session->stats_lock);
+  if (bytes_sent)
+    *bytes_sent = session->bytes_sent;
+  if (bytes_sent_uncompressed)
+    *bytes_sent_uncompressed = session->bytes_sent_uncompressed;
+  if (bytes_received)
+    *bytes_received = session->bytes_received;
+  if (bytes_received_decoded)
+    *bytes_received_decoded = session->bytes_received_decoded;
+  g_mutex_unlock (&session->stats_lock);
+}
+
+static void
+open_projects_send_cb (GObject      *source_object,
+                       GAsyncResult *res,
+                       gpointer      user_data)
+{
+  ZanataSession *session = ZANATA_SESSION (source_object);
+  GTask *task = G_TASK (user_data);
+  GError *error = NULL;
+  GInputStream *stream;
+
+  stream = zanata_session_send_finish (session, res, &error);
+  if (!stream)
+    {
+      g_task_return_error (task, error);
+      g_object_unref (task);
+      return;
+    }
+
+  g_task_return_pointer (task,
+                         _zanata_project_stream_new (session, stream),
+                         g_object_unref);
+  g_object_unref (stream);
+  g_object_unref (task);
+}
+
+/**
+ * zanata_session_open_projects:
+ * @session: a #ZanataSession
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: a #GAsyncReadyCallback
+ * @user_data: (nullable): a user data
+ *
+ * Starts retrieving the project catalog as a #ZanataProjectStream,
+ * which decodes projects incrementally while the response is being
+ * downloaded.  This operation is asynchronous and shall be finished
+ * with zanata_session_open_projects_finish().
+ */
+void
+zanata_session_open_projects (ZanataSession       *session,
+                              GCancellable        *cancellable,
+                              GAsyncReadyCallback  callback,
+                              gpointer             user_data)
+{
+  GTask *task;
+  SoupURI *uri;
+  ZanataRequest *request;
+
+  task = g_task_new (session, cancellable, callback, user_data);
+  uri = _zanata_session_build_endpoint (session,
+                                        ZANATA_ENDPOINT_PROJECTS,
+                                        NULL);
+  request = zanata_request_new ("GET", uri);
+  soup_uri_free (uri);
+  zanata_request_set_accept (request, "application/json");
+
+  zanata_session_send (session,
+                       request,
+                       cancellable,
+                       open_projects_send_cb,
+                       task);
+  g_object_unref (request);
+}
+
+/**
+ * zanata_session_open_projects_finish:
+ * @session: a #ZanataSession
+ * @result: a #GAsyncResult
+ * @error: error location
+ *
+ * Finishes zanata_session_open_projects() operation.
+ *
+ * Returns: (transfer full): a #ZanataProjectStream
+ */
+ZanataProjectStream *
+zanata_session_open_projects_finish (ZanataSession  *session,
+                                     GAsyncResult   *result,
+                                     GError        **error)
+{
+  g_return_val_if_fail (g_task_is_valid (result, session), NULL);
+  return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+static void
+get_projects_next_cb (GObject      *source_object,
+                      GAsyncResult *res,
+                      gpointer      user_data)
+{
+  ZanataProjectStream *stream = ZANATA_PROJECT_STREAM (source_object);
+  GTask *task = G_TASK (user_data);
+  ZanataSession *session = g_task_get_source_object (task);
+  GError *error = NULL;
+  GListModel *projects;
+
+  projects = zanata_project_stream_next_finish_model (stream, res, &error);
+  if (!projects)
+    g_task_return_error (task, error);
+  else
+    {
+      _zanata_session_set_cached_object (session,
+                                         g_task_get_task_data (task),
+                                         G_OBJECT (projects));
+      g_task_return_pointer (task, projects, g_object_unref);
+    }
+  g_object_unref (stream);
+  g_object_unref (task);
+}
+
+static void
+get_projects_send_cb (GObject      *source_object,
+                      GAsyncResult *res,
+                      gpointer      user_data)
+{
+  ZanataSession *session = ZANATA_SESSION (source_object);
+  GTask *task = G_TASK (user_data);
   GError *error = NULL;
   GInputStream *stream;
+  ZanataProjectStream *project_stream;
+  GObject *projects;
+  gchar *cache_key;
 
-  stream = zanata_session_invoke_finish (session, res, &error);
+  stream = _zanata_session_send_cached_finish (session, res,
+                                               &cache_key, &projects,
+                                               &error);
   if (!stream)
     {
-      g_task_return_error (task, error);
+      g_free (cache_key);
+      if (projects)
+        g_task_return_pointer (task, projects, g_object_unref);
+      else
+        g_task_return_error (task, error);
       g_object_unref (task);
       return;
     }
 
-  parser = json_parser_new ();
-  json_parser_load_from_stream_async (parser,
-                                      stream,
-                                      g_task_get_cancellable (task),
-                                      get_suggestions_load_cb,
-                                      task);
+  g_task_set_task_data (task, cache_key, g_free);
+  project_stream = _zanata_project_stream_new (session, stream);
+  g_object_unref (stream);
+  zanata_project_stream_next_async (project_stream,
+                                    G_MAXUINT,
+                                    g_task_get_cancellable (task),
+                                    get_projects_next_cb,
+                                    task);
 }
 
 /**
- * zanata_session_get_suggestions:
+ * zanata_session_get_projects:
  * @session: a #ZanataSession
- * @query: (array zero-terminated=1) (element-type utf8): an array of
- *   query strings
- * @from_locale: a locale id of source contents
- * @to_locale: a locale id of target contents
  * @cancellable: (nullable): a #GCancellable
  * @callback: a #GAsyncReadyCallback
  * @user_data: (nullable): a user data
  *
- * Starts retrieving suggestions matching @query.  This operation is
- * asynchronous and shall be finished with
- * zanata_session_get_suggestions_finish().
+ * Starts retrieving the whole project catalog.  If #ZanataSession:cache-enabled
+ * is set, the catalog is revalidated with a conditional request and
+ * the previously decoded projects are returned as long as the server
+ * reports them unchanged.  This operation is asynchronous and shall be
+ * finished with zanata_session_get_projects_finish().
  */
 void
-zanata_session_get_suggestions (ZanataSession       *session,
-                                const gchar * const *query,
-                                const gchar         *from_locale,
-                                const gchar         *to_locale,
-                                GCancellable        *cancellable,
-                                GAsyncReadyCallback  callback,
-                                gpointer             user_data)
+zanata_session_get_projects (ZanataSession       *session,
+                             GCancellable        *cancellable,
+                             GAsyncReadyCallback  callback,
+                             gpointer             user_data)
 {
   GTask *task;
-  SoupSession *soup_session;
-  SoupMessage *soup_message;
   SoupURI *uri;
-  GPtrArray *array;
-  ZanataParameter *parameter;
-  ZanataParameter **parameters;
-  JsonBuilder *builder;
-  JsonGenerator *generator;
-  gchar *data;
-  gsize data_length;
-
-  builder = json_builder_new ();
-  json_builder_begin_array (builder);
-  while (*query)
-    {
-      json_builder_add_string_value (builder, *query);
-      query++;
-    }
-  json_builder_end_array (builder);
-
-  generator = json_generator_new ();
-  json_generator_set_root (generator, json_builder_get_root (builder));
-  g_object_unref (builder);
-  data = json_generator_to_data (generator, &data_length);
-  g_object_unref (generator);
+  ZanataRequest *request;
 
   task = g_task_new (session, cancellable, callback, user_data);
-  uri = zanata_session_get_endpoint (session, "/rest/suggestions");
-
-  array =
-    g_ptr_array_new_with_free_func ((GDestroyNotify) zanata_parameter_free);
-
-  parameter = g_new0 (ZanataParameter, 1);
-  parameter->name = g_strdup ("from");
-  parameter->value = g_strdup (from_locale);
-  g_ptr_array_add (array, parameter);
-
-  parameter = g_new0 (ZanataParameter, 1);
-  parameter->name = g_strdup ("to");
-  parameter->value = g_strdup (to_locale);
-  g_ptr_array_add (array, parameter);
-  g_ptr_array_add (array, NULL);
-
-  parameters = (ZanataParameter **) g_ptr_array_free (array, FALSE);
-
-  zanata_session_invoke (session,
-                         "POST",
-                         uri,
-                         parameters,
-                         "application/json",
-                         data,
-                         data_length,
-                         "application/json",
-                         cancellable,
-                         get_suggestions_invoke_cb,
-                         task);
-
+  uri = _zanata_session_build_endpoint (session,
+                                        ZANATA_ENDPOINT_PROJECTS,
+                                        NULL);
+  request = zanata_request_new ("GET", uri);
   soup_uri_free (uri);
-  while (*parameters)
-    {
-      zanata_parameter_free (*parameters);
-      parameters++;
-    }
+  zanata_request_set_accept (request, "application/json");
+
+  _zanata_session_send_cached (session,
+                               request,
+                               FALSE,
+                               cancellable,
+                               get_projects_send_cb,
+                               task);
+  g_object_unref (request);
 }
 
 /**
- * zanata_session_get_suggestions_finish:
+ * zanata_session_get_projects_finish:
  * @session: a #ZanataSession
  * @result: a #GAsyncResult
  * @error: error location
  *
- * Finishes zanata_session_get_suggestions() operation.
+ * Finishes zanata_session_get_projects() operation.
  *
- * Returns: (transfer full) (element-type ZanataSuggestion): a list of
- * suggestions
+ * Returns: (transfer full) (element-type ZanataProject): a list of
+ * #ZanataProject
  */
 GList *
-zanata_session_get_suggestions_finish (ZanataSession  *session,
-                                       GAsyncResult   *result,
-                                       GError        **error)
-{
-  g_return_val_if_fail (g_task_is_valid (result, session), NULL);
-  return g_task_propagate_pointer (G_TASK (result), error);
-}
-
-static void
-collect_projects (JsonArray *array,
-                  guint      index_,
-                  JsonNode  *element_node,
-                  gpointer   user_data)
+zanata_session_get_projects_finish (ZanataSession  *session,
+                                    GAsyncResult   *result,
+                                    GError        **error)
 {
-  GList **projects = user_data;
-  JsonObject *object;
-  const gchar *id, *name, *status;
-  gchar *status_nick;
-  ZanataProjectStatus status_value;
-  ZanataProject *project;
-  GEnumClass *enum_class;
-  GEnumValue *enum_value;
-
-  if (json_node_get_node_type (element_node) != JSON_NODE_OBJECT)
-    return;
-
-  object = json_node_get_object (element_node);
-  id = json_object_get_string_member (object, "id");
-  if (!id)
-    return;
-
-  name = json_object_get_string_member (object, "name");
-  if (!name)
-    return;
-
-  status = json_object_get_string_member (object, "status");
-  if (!status)
-    return;
-
-  enum_class = g_type_class_ref (ZANATA_TYPE_PROJECT_STATUS);
-  status_nick = g_ascii_strdown (status, -1);
-  enum_value = g_enum_get_value_by_nick (enum_class, status_nick);
-  g_free (status_nick);
-  if (enum_value)
-    status_value = enum_value->value;
-  else
-    status_value = ZANATA_PROJECT_STATUS_UNKNOWN;
-
-  project = g_object_new (ZANATA_TYPE_PROJECT,
-                          "id", id,
-                          "name", name,
-                          "status", status_value,
-                          "loaded", FALSE,
-                          NULL);
-  g_type_class_unref (enum_class);
-  *projects = g_list_append (*projects, project);
+  GListModel *model;
+  GList *projects;
+
+  model = zanata_session_get_projects_finish_model (session, result, error);
+  if (!model)
+    return NULL;
+
+  /* The cached model may be a catalog decoded by
+     zanata_session_get_project_catalog() for the same response.  */
+  projects = _zanata_list_model_to_list (model);
+  g_object_unref (model);
+  return projects;
 }
 
-static void
-free_projects (GList *projects)
+/**
+ * zanata_session_get_projects_finish_model:
+ * @session: a #ZanataSession
+ * @result: a #GAsyncResult
+ * @error: error location
+ *
+ * Finishes zanata_session_get_projects() operation, like
+ * zanata_session_get_projects_finish(), but returns the projects as a
+ * #GListModel.
+ *
+ * Returns: (transfer full): a #GListModel of #ZanataProject
+ */
+GListModel *
+zanata_session_get_projects_finish_model (ZanataSession  *session,
+                                          GAsyncResult   *result,
+                                          GError        **error)
 {
-  g_list_free_full (projects, g_object_unref);
+  g_return_val_if_fail (g_task_is_valid (result, session), NULL);
+  return g_task_propagate_pointer (G_TASK (result), error);
 }
 
 static void
-get_projects_load_cb (GObject      *source_object,
-                      GAsyncResult *res,
-                      gpointer      user_data)
+get_project_catalog_load_cb (GObject      *source_object,
+                             GAsyncResult *res,
+                             gpointer      user_data)
 {
-  JsonParser *parser = JSON_PARSER (source_object);
+  ZanataProjectCatalog *catalog = ZANATA_PROJECT_CATALOG (source_object);
   GTask *task = G_TASK (user_data);
+  ZanataSession *session = g_task_get_source_object (task);
   GError *error = NULL;
-  GList *projects = NULL;
-  JsonNode *node;
-  JsonArray *array;
 
-  if (!json_parser_load_from_stream_finish (parser, res, &error))
+  if (!_zanata_project_catalog_load_finish (catalog, res, &error))
     {
       g_task_return_error (task, error);
+      g_object_unref (catalog);
       g_object_unref (task);
       return;
     }
 
-  node = json_parser_get_root (parser);
-  if (json_node_get_node_type (node) != JSON_NODE_ARRAY)
-    {
-      g_task_return_new_error (task,
-                               ZANATA_ERROR,
-                               ZANATA_ERROR_INVALID_RESPONSE,
-                               "root element is not an array");
-      g_object_unref (task);
-      return;
-    }
-
-  array = json_node_get_array (node);
-  json_array_foreach_element (array, collect_projects, &projects);
-  g_task_return_pointer (task, projects, (GDestroyNotify) free_projects);
+  _zanata_session_set_cached_object (session,
+                                     g_task_get_task_data (task),
+                                     G_OBJECT (catalog));
+  g_task_return_pointer (task, catalog, g_object_unref);
   g_object_unref (task);
 }
 
 static void
-get_projects_invoke_cb (GObject      *source_object,
-                        GAsyncResult *res,
-                        gpointer      user_data)
+get_project_catalog_send_cb (GObject      *source_object,
+                             GAsyncResult *res,
+                             gpointer      user_data)
 {
   ZanataSession *session = ZANATA_SESSION (source_object);
   GTask *task = G_TASK (user_data);
-  JsonParser *parser;
   GError *error = NULL;
   GInputStream *stream;
+  ZanataProjectCatalog *catalog;
+  GObject *cached;
+  gchar *cache_key;
 
-  stream = zanata_session_invoke_finish (session, res, &error);
+  stream = _zanata_session_send_cached_finish (session, res,
+                                               &cache_key, &cached,
+                                               &error);
   if (!stream)
     {
-      g_task_return_error (task, error);
+      g_free (cache_key);
+
+      /* The cached object may be the model built by
+         zanata_session_get_projects() for the same response.  */
+      if (cached && !ZANATA_IS_PROJECT_CATALOG (cached))
+        {
+          catalog = _zanata_project_catalog_new_from_model (session,
+                                                            G_LIST_MODEL (cached));
+          g_object_unref (cached);
+          cached = G_OBJECT (catalog);
+        }
+
+      if (cached)
+        g_task_return_pointer (task, cached, g_object_unref);
+      else
+        g_task_return_error (task, error);
       g_object_unref (task);
       return;
     }
 
-  parser = json_parser_new ();
-  json_parser_load_from_stream_async (parser,
+  g_task_set_task_data (task, cache_key, g_free);
+  catalog = _zanata_project_catalog_new (session);
+  _zanata_project_catalog_load_async (catalog,
                                       stream,
                                       g_task_get_cancellable (task),
-                                      get_projects_load_cb,
+                                      get_project_catalog_load_cb,
                                       task);
+  g_object_unref (stream);
 }
 
+/**
+ * zanata_session_get_project_catalog:
+ * @session: a #ZanataSession
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: a #GAsyncReadyCallback
+ * @user_data: (nullable): a user data
+ *
+ * Starts retrieving the whole project catalog as a
+ * #ZanataProjectCatalog, which stores the project ids, names and
+ * statuses compactly and only creates #ZanataProject objects on
+ * demand.  This is preferable to zanata_session_get_projects() on
+ * servers hosting many projects.  This operation is asynchronous and
+ * shall be finished with zanata_session_get_project_catalog_finish().
+ */
 void
-zanata_session_get_projects (ZanataSession       *session,
-                             GCancellable        *cancellable,
-                             GAsyncReadyCallback  callback,
-                             gpointer             user_data)
+zanata_session_get_project_catalog (ZanataSession       *session,
+                                    GCancellable        *cancellable,
+                                    GAsyncReadyCallback  callback,
+                                    gpointer             user_data)
 {
   GTask *task;
   SoupURI *uri;
+  ZanataRequest *request;
 
   task = g_task_new (session, cancellable, callback, user_data);
-  uri = zanata_session_get_endpoint (session, "/rest/projects");
-  zanata_session_invoke (session,
-                         "GET",
-                         uri,
-                         NULL,
-                         "application/json",
-                         NULL,
-                         -1,
-                         "application/json",
-                         cancellable,
-                         get_projects_invoke_cb,
-                         task);
+  uri = _zanata_session_build_endpoint (session,
+                                        ZANATA_ENDPOINT_PROJECTS,
+                                        NULL);
+  request = zanata_request_new ("GET", uri);
   soup_uri_free (uri);
+  zanata_request_set_accept (request, "application/json");
+
+  _zanata_session_send_cached (session,
+                               request,
+                               FALSE,
+                               cancellable,
+                               get_project_catalog_send_cb,
+                               task);
+  g_object_unref (request);
 }
 
 /**
- * zanata_session_get_projects_finish:
+ * zanata_session_get_project_catalog_finish:
  * @session: a #ZanataSession
  * @result: a #GAsyncResult
  * @error: error location
  *
- * Finishes zanata_session_get_projects() operation.
+ * Finishes zanata_session_get_project_catalog() operation.
  *
- * Returns: (transfer full) (element-type ZanataProject): a list of
- * #ZanataProject
+ * Returns: (transfer full): a #ZanataProjectCatalog
  */
-GList *
-zanata_session_get_projects_finish (ZanataSession  *session,
-                                    GAsyncResult   *result,
-                                    GError        **error)
+ZanataProjectCatalog *
+zanata_session_get_project_catalog_finish (ZanataSession  *session,
+                                           GAsyncResult   *result,
+                                           GError        **error)
 {
   g_return_val_if_fail (g_task_is_valid (result, session), NULL);
   return g_task_propagate_pointer (G_TASK (result), error);
@@ -833,11 +3410,8 @@ collect_iterations (JsonArray *array,
   ZanataProject *project = user_data;
   JsonObject *object;
   const gchar *id, *status;
-  gchar *status_nick;
-  ZanataProjectStatus status_value;
+  ZanataIterationStatus status_value;
   ZanataIteration *iteration;
-  GEnumClass *enum_class;
-  GEnumValue *enum_value;
 
   if (json_node_get_node_type (element_node) != JSON_NODE_OBJECT)
     return;
@@ -853,14 +3427,9 @@ collect_iterations (JsonArray *array,
   if (!status)
     return;
 
-  enum_class = g_type_class_ref (ZANATA_TYPE_ITERATION_STATUS);
-  status_nick = g_ascii_strdown (status, -1);
-  enum_value = g_enum_get_value_by_nick (enum_class, status_nick);
-  g_free (status_nick);
-  if (enum_value)
-    status_value = enum_value->value;
-  else
-    status_value = ZANATA_ITERATION_STATUS_UNKNOWN;
+  status_value =
+    _zanata_iteration_status_from_nick (status,
+                                        ZANATA_ITERATION_STATUS_UNKNOWN);
 
   iteration = g_object_new (ZANATA_TYPE_ITERATION,
                             "project", project,
@@ -870,108 +3439,101 @@ collect_iterations (JsonArray *array,
   _zanata_project_add_iteration (project, iteration);
 }
 
-static void
-get_project_load_cb (GObject      *source_object,
-                     GAsyncResult *res,
-                     gpointer      user_data)
+static GObject *
+decode_project (ZanataSession  *session,
+                JsonNode       *root,
+                GError        **error)
 {
-  JsonParser *parser = JSON_PARSER (source_object);
-  GTask *task = G_TASK (user_data);
-  GError *error = NULL;
-  JsonNode *node;
   JsonObject *object;
   JsonArray *array;
   const gchar *id, *name, *status;
-  gchar *status_nick;
-  ZanataProjectStatus status_value;
   ZanataProject *project;
-  GEnumClass *enum_class;
-  GEnumValue *enum_value;
-
-  if (!json_parser_load_from_stream_finish (parser, res, &error))
-    {
-      g_task_return_error (task, error);
-      g_object_unref (task);
-      return;
-    }
 
-  node = json_parser_get_root (parser);
-  if (json_node_get_node_type (node) != JSON_NODE_OBJECT)
+  if (json_node_get_node_type (root) != JSON_NODE_OBJECT)
     {
-      g_task_return_new_error (task,
-                               ZANATA_ERROR,
-                               ZANATA_ERROR_INVALID_RESPONSE,
-                               "root element is not an array");
-      g_object_unref (task);
-      return;
+      g_set_error_literal (error,
+                           ZANATA_ERROR,
+                           ZANATA_ERROR_INVALID_RESPONSE,
+                           "root element is not an object");
+      return NULL;
     }
 
-  object = json_node_get_object (node);
+  object = json_node_get_object (root);
   id = json_object_get_string_member (object, "id");
   if (!id)
     {
-      g_task_return_new_error (task,
-                               ZANATA_ERROR,
-                               ZANATA_ERROR_INVALID_RESPONSE,
-                               "\"id\" is not given");
-      g_object_unref (task);
-      return;
+      g_set_error_literal (error,
+                           ZANATA_ERROR,
+                           ZANATA_ERROR_INVALID_RESPONSE,
+                           "\"id\" is not given");
+      return NULL;
     }
 
   name = json_object_get_string_member (object, "name");
   if (!name)
     {
-      g_task_return_new_error (task,
-                               ZANATA_ERROR,
-                               ZANATA_ERROR_INVALID_RESPONSE,
-                               "\"name\" is not given");
-      g_object_unref (task);
-      return;
+      g_set_error_literal (error,
+                           ZANATA_ERROR,
+                           ZANATA_ERROR_INVALID_RESPONSE,
+                           "\"name\" is not given");
+      return NULL;
     }
 
   status = json_object_get_string_member (object, "status");
   if (!status)
     {
-      g_task_return_new_error (task,
-                               ZANATA_ERROR,
-                               ZANATA_ERROR_INVALID_RESPONSE,
-                               "\"status\" is not given");
-      g_object_unref (task);
-      return;
+      g_set_error_literal (error,
+                           ZANATA_ERROR,
+                           ZANATA_ERROR_INVALID_RESPONSE,
+                           "\"status\" is not given");
+      return NULL;
     }
 
-  enum_class = g_type_class_ref (ZANATA_TYPE_PROJECT_STATUS);
-  status_nick = g_ascii_strdown (status, -1);
-  enum_value = g_enum_get_value_by_nick (enum_class, status_nick);
-  g_free (status_nick);
-
-  if (enum_value)
-    status_value = enum_value->value;
-  else
-    status_value = ZANATA_PROJECT_STATUS_UNKNOWN;
-
   array = json_object_get_array_member (object, "iterations");
   if (!array)
     {
-      g_task_return_new_error (task,
-                               ZANATA_ERROR,
-                               ZANATA_ERROR_INVALID_RESPONSE,
-                               "\"iterations\" is not given");
-      g_object_unref (task);
-      return;
+      g_set_error_literal (error,
+                           ZANATA_ERROR,
+                           ZANATA_ERROR_INVALID_RESPONSE,
+                           "\"iterations\" is not given");
+      return NULL;
     }
 
   project = g_object_new (ZANATA_TYPE_PROJECT,
-                          "session", g_task_get_task_data (task),
+                          "session", session,
                           "id", id,
                           "name", name,
-                          "status", status_value,
+                          "status",
+                          _zanata_project_status_from_nick
+                          (status, ZANATA_PROJECT_STATUS_UNKNOWN),
                           "loaded", TRUE,
                           NULL);
-  g_type_class_unref (enum_class);
 
   json_array_foreach_element (array, collect_iterations, project);
+  return G_OBJECT (project);
+}
 
+static void
+get_project_load_cb (GObject      *source_object,
+                     GAsyncResult *res,
+                     gpointer      user_data)
+{
+  ZanataSession *session = ZANATA_SESSION (source_object);
+  GTask *task = G_TASK (user_data);
+  GError *error = NULL;
+  GObject *project;
+
+  project = decode_json_finish (session, res, &error);
+  if (!project)
+    {
+      g_task_return_error (task, error);
+      g_object_unref (task);
+      return;
+    }
+
+  _zanata_session_set_cached_object (session,
+                                     g_task_get_task_data (task),
+                                     project);
   g_task_return_pointer (task, project, g_object_unref);
   g_object_unref (task);
 }
@@ -985,25 +3547,157 @@ get_project_invoke_cb (GObject      *source_object,
   GTask *task = G_TASK (user_data);
   GError *error = NULL;
   GInputStream *stream;
-  JsonParser *parser;
+  GObject *project;
+  gchar *cache_key;
 
-  stream = zanata_session_invoke_finish (session, res, &error);
+  stream = _zanata_session_send_cached_finish (session, res,
+                                               &cache_key, &project,
+                                               &error);
   if (!stream)
     {
-      g_task_return_error (task, error);
+      g_free (cache_key);
+      if (project)
+        g_task_return_pointer (task, project, g_object_unref);
+      else
+        g_task_return_error (task, error);
       g_object_unref (task);
       return;
     }
 
-  g_task_set_task_data (task, session, g_object_unref);
-  parser = json_parser_new ();
-  json_parser_load_from_stream_async (parser,
-                                      stream,
-                                      g_task_get_cancellable (task),
-                                      get_project_load_cb,
-                                      task);
+  g_task_set_task_data (task, cache_key, g_free);
+  decode_json_async (session,
+                     res,
+                     stream,
+                     decode_project,
+                     g_task_get_cancellable (task),
+                     get_project_load_cb,
+                     task);
+  g_object_unref (stream);
+}
+
+/* A caller of zanata_session_get_project() waiting for a shared
+   load.  The waiter is referenced by the project_loads queue and by
+   its cancel source, if any; whichever removes it from the queue
+   under project_loads_lock completes the task.  */
+typedef struct _ProjectWaiter ProjectWaiter;
+
+struct _ProjectWaiter
+{
+  gint ref_count;
+  gchar *project_id;
+  GTask *task;
+  GSource *cancel_source;
+};
+
+static ProjectWaiter *
+project_waiter_ref (ProjectWaiter *waiter)
+{
+  g_atomic_int_inc (&waiter->ref_count);
+  return waiter;
+}
+
+static void
+project_waiter_unref (ProjectWaiter *waiter)
+{
+  if (!g_atomic_int_dec_and_test (&waiter->ref_count))
+    return;
+
+  g_free (waiter->project_id);
+  g_object_unref (waiter->task);
+  g_slice_free (ProjectWaiter, waiter);
+}
+
+/* Detaches WAITER from its cancellable and drops the queue's
+   reference.  */
+static void
+project_waiter_release (ProjectWaiter *waiter)
+{
+  if (waiter->cancel_source)
+    {
+      g_source_destroy (waiter->cancel_source);
+      g_source_unref (waiter->cancel_source);
+      waiter->cancel_source = NULL;
+    }
+  project_waiter_unref (waiter);
+}
+
+static gboolean
+project_waiter_cancelled_cb (GCancellable *cancellable,
+                             gpointer      user_data)
+{
+  ProjectWaiter *waiter = user_data;
+  ZanataSession *session = g_task_get_source_object (waiter->task);
+  GQueue *waiters;
+  gboolean removed = FALSE;
+
+  /* The shared load keeps running for the other waiters, or for the
+     cache if none is left.  */
+  g_mutex_lock (&session->project_loads_lock);
+  waiters = g_hash_table_lookup (session->project_loads, waiter->project_id);
+  if (waiters != NULL)
+    removed = g_queue_remove (waiters, waiter);
+  g_mutex_unlock (&session->project_loads_lock);
+
+  if (removed)
+    {
+      g_task_return_error_if_cancelled (waiter->task);
+      project_waiter_release (waiter);
+    }
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+get_project_complete_cb (GObject      *source_object,
+                         GAsyncResult *res,
+                         gpointer      user_data)
+{
+  ZanataSession *session = ZANATA_SESSION (source_object);
+  gchar *project_id = user_data;
+  ZanataProject *project;
+  GError *error = NULL;
+  GQueue *waiters;
+  ProjectWaiter *waiter;
+
+  project = g_task_propagate_pointer (G_TASK (res), &error);
+
+  g_mutex_lock (&session->project_loads_lock);
+  waiters = g_hash_table_lookup (session->project_loads, project_id);
+  g_hash_table_steal (session->project_loads, project_id);
+  g_mutex_unlock (&session->project_loads_lock);
+
+  while ((waiter = g_queue_pop_head (waiters)) != NULL)
+    {
+      if (project)
+        g_task_return_pointer (waiter->task,
+                               g_object_ref (project),
+                               g_object_unref);
+      else
+        g_task_return_error (waiter->task, g_error_copy (error));
+      project_waiter_release (waiter);
+    }
+  g_queue_free (waiters);
+
+  g_clear_object (&project);
+  g_clear_error (&error);
+  g_free (project_id);
 }
 
+/**
+ * zanata_session_get_project:
+ * @session: a #ZanataSession
+ * @project_id: a project id
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: a #GAsyncReadyCallback
+ * @user_data: (nullable): a user data
+ *
+ * Starts retrieving the project identified by @project_id, together
+ * with its iterations.  Concurrent calls for the same project share a
+ * single request; cancelling one of them completes that caller at once
+ * with %G_IO_ERROR_CANCELLED and leaves the shared request running.
+ * This operation is asynchronous and shall be finished with
+ * zanata_session_get_project_finish().
+ */
 void
 zanata_session_get_project (ZanataSession       *session,
                             const gchar         *project_id,
@@ -1012,28 +3706,68 @@ zanata_session_get_project (ZanataSession       *session,
                             gpointer             user_data)
 {
   GTask *task;
+  ProjectWaiter *waiter;
+  GQueue *waiters;
   SoupURI *uri;
-  gchar *escaped, *path;
+  ZanataRequest *request;
+  const gchar *args[1];
 
   task = g_task_new (session, cancellable, callback, user_data);
+  if (g_task_return_error_if_cancelled (task))
+    {
+      g_object_unref (task);
+      return;
+    }
 
-  escaped = soup_uri_encode (project_id, NULL);
-  path = g_strdup_printf ("/rest/projects/p/%s", escaped);
-  g_free (escaped);
+  waiter = g_slice_new0 (ProjectWaiter);
+  waiter->ref_count = 1;
+  waiter->project_id = g_strdup (project_id);
+  waiter->task = task;
 
-  uri = zanata_session_get_endpoint (session, path);
-  zanata_session_invoke (session,
-                         "GET",
-                         uri,
-                         NULL,
-                         "application/json",
-                         NULL,
-                         -1,
-                         "application/json",
-                         cancellable,
-                         get_project_invoke_cb,
-                         task);
+  g_mutex_lock (&session->project_loads_lock);
+  if (cancellable)
+    {
+      /* Attached under the lock, so that the callback cannot look
+         the waiter up before it is queued.  */
+      waiter->cancel_source = g_cancellable_source_new (cancellable);
+      g_source_set_callback (waiter->cancel_source,
+                             (GSourceFunc) project_waiter_cancelled_cb,
+                             project_waiter_ref (waiter),
+                             (GDestroyNotify) project_waiter_unref);
+      g_source_attach (waiter->cancel_source,
+                       g_main_context_get_thread_default ());
+    }
+  waiters = g_hash_table_lookup (session->project_loads, project_id);
+  if (waiters != NULL)
+    {
+      g_queue_push_tail (waiters, waiter);
+      g_mutex_unlock (&session->project_loads_lock);
+      return;
+    }
+  waiters = g_queue_new ();
+  g_queue_push_tail (waiters, waiter);
+  g_hash_table_insert (session->project_loads, g_strdup (project_id), waiters);
+  g_mutex_unlock (&session->project_loads_lock);
+
+  /* The shared load is not cancellable, since it may outlive the
+     caller which started it.  */
+  task = g_task_new (session, NULL,
+                     get_project_complete_cb, g_strdup (project_id));
+
+  args[0] = project_id;
+  uri = _zanata_session_build_endpoint (session, ZANATA_ENDPOINT_PROJECT,
+                                        args);
+  request = zanata_request_new ("GET", uri);
   soup_uri_free (uri);
+  zanata_request_set_accept (request, "application/json");
+
+  _zanata_session_send_cached (session,
+                               request,
+                               FALSE,
+                               NULL,
+                               get_project_invoke_cb,
+                               task);
+  g_object_unref (request);
 }
 
 /**
@@ -4,6 +4,9 @@
 #include <glib-object.h>
 #include "zanata-authorizer.h"
 #include "zanata-project.h"
+#include "zanata-project-catalog.h"
+#include "zanata-project-stream.h"
+#include "zanata-request.h"
 
 G_BEGIN_DECLS
 
@@ -32,6 +35,20 @@ ZanataSession *zanata_session_new (ZanataAuthorizer    *authorizer,
 SoupURI       *zanata_session_get_endpoint
                                   (ZanataSession       *session,
                                    const gchar         *mountpoint);
+guint          zanata_session_get_queue_depth
+                                  (ZanataSession       *session,
+                                   ZanataRequestPriority
+                                                        priority);
+void           zanata_session_send
+                                  (ZanataSession       *session,
+                                   ZanataRequest       *request,
+                                   GCancellable        *cancellable,
+                                   GAsyncReadyCallback  callback,
+                                   gpointer             user_data);
+GInputStream  *zanata_session_send_finish
+                                  (ZanataSession       *session,
+                                   GAsyncResult        *result,
+                                   GError             **error);
 void           zanata_session_invoke
                                   (ZanataSession       *session,
                                    const gchar         *method,
@@ -48,6 +65,21 @@ GInputStream  *zanata_session_invoke_finish
                                   (ZanataSession       *session,
                                    GAsyncResult        *result,
                                    GError             **error);
+void           zanata_session_invoke_bytes
+                                  (ZanataSession       *session,
+                                   const gchar         *method,
+                                   SoupURI             *endpoint,
+                                   ZanataParameter    **parameters,
+                                   const gchar         *request_content_type,
+                                   GBytes              *request,
+                                   const gchar         *response_content_type,
+                                   GCancellable        *cancellable,
+                                   GAsyncReadyCallback  callback,
+                                   gpointer             user_data);
+GBytes        *zanata_session_invoke_bytes_finish
+                                  (ZanataSession       *session,
+                                   GAsyncResult        *result,
+                                   GError             **error);
 void           zanata_session_get_suggestions
                                   (ZanataSession       *session,
                                    const gchar * const *query,
@@ -61,6 +93,39 @@ GList         *zanata_session_get_suggestions_finish
                                   (ZanataSession       *session,
                                    GAsyncResult        *result,
                                    GError             **error);
+GListModel    *zanata_session_get_suggestions_finish_model
+                                  (ZanataSession       *session,
+                                   GAsyncResult        *result,
+                                   GError             **error);
+
+void           zanata_session_get_suggestion_cache_stats
+                                  (ZanataSession       *session,
+                                   guint               *hits,
+                                   guint               *misses);
+
+void           zanata_session_get_transfer_stats
+                                  (ZanataSession       *session,
+                                   guint64             *bytes_sent,
+                                   guint64             *bytes_sent_uncompressed,
+                                   guint64             *bytes_received,
+                                   guint64             *bytes_received_decoded);
+
+void           zanata_session_open_projects
+                                  (ZanataSession       *session,
+                                   GCancellable        *cancellable,
+                                   GAsyncReadyCallback  callback,
+                                   gpointer             user_data);
+
+ZanataProjectStream *
+               zanata_session_open_projects_finish
+                                  (ZanataSession       *session,
+                                   GAsyncResult        *result,
+                                   GError             **error);
+
+ZanataProjectStream *
+               _zanata_project_stream_new
+                                  (ZanataSession       *session,
+                                   GInputStream        *input);
 
 void           zanata_session_get_projects
                                   (ZanataSession       *session,
@@ -72,6 +137,30 @@ GList         *zanata_session_get_projects_finish
                                   (ZanataSession       *session,
                                    GAsyncResult        *result,
                                    GError             **error);
+GListModel    *zanata_session_get_projects_finish_model
+                                  (ZanataSession       *session,
+                                   GAsyncResult        *result,
+                                   GError             **error);
+
+void           zanata_session_get_project_catalog
+                                  (ZanataSession       *session,
+                                   GCancellable        *cancellable,
+                                   GAsyncReadyCallback  callback,
+                                   gpointer             user_data);
+
+ZanataProjectCatalog *
+               zanata_session_get_project_catalog_finish
+                                  (ZanataSession       *session,
+                                   GAsyncResult        *result,
+                                   GError             **error);
+
+ZanataProjectCatalog *
+               _zanata_project_catalog_new
+                                  (ZanataSession       *session);
+ZanataProjectCatalog *
+               _zanata_project_catalog_new_from_model
+                                  (ZanataSession       *session,
+                                   GListModel          *projects);
 
 void           zanata_session_get_project
                                   (ZanataSession       *session,
@@ -85,6 +174,24 @@ ZanataProject *zanata_session_get_project_finish
                                    GAsyncResult        *result,
                                    GError             **error);
 
+void           _zanata_session_send_cached
+                                  (ZanataSession       *session,
+                                   ZanataRequest       *request,
+                                   gboolean             keep_body,
+                                   GCancellable        *cancellable,
+                                   GAsyncReadyCallback  callback,
+                                   gpointer             user_data);
+GInputStream  *_zanata_session_send_cached_finish
+                                  (ZanataSession       *session,
+                                   GAsyncResult        *result,
+                                   gchar              **cache_key,
+                                   GObject            **cached_object,
+                                   GError             **error);
+void           _zanata_session_set_cached_object
+                                  (ZanataSession       *session,
+                                   const gchar         *cache_key,
+                                   GObject             *object);
+
 G_END_DECLS
 
 #endif  /* ZANATA_SESSION_H */
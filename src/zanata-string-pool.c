@@ -0,0 +1,101 @@
+#include "config.h"
+
+#include "zanata-string-pool.h"
+
+#include <string.h>
+
+typedef struct _PoolEntry PoolEntry;
+
+struct _PoolEntry
+{
+  guint count;
+  gchar string[1];
+};
+
+struct _ZanataStringPool
+{
+  gint ref_count;
+  GMutex mutex;
+
+  /* Maps each interned string to its entry, which holds the string
+     itself and the number of its holders.  */
+  GHashTable *strings;
+};
+
+ZanataStringPool *
+_zanata_string_pool_new (void)
+{
+  ZanataStringPool *pool = g_new0 (ZanataStringPool, 1);
+
+  pool->ref_count = 1;
+  g_mutex_init (&pool->mutex);
+  pool->strings = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                         NULL, g_free);
+  return pool;
+}
+
+ZanataStringPool *
+_zanata_string_pool_ref (ZanataStringPool *pool)
+{
+  g_atomic_int_inc (&pool->ref_count);
+  return pool;
+}
+
+void
+_zanata_string_pool_unref (ZanataStringPool *pool)
+{
+  if (!g_atomic_int_dec_and_test (&pool->ref_count))
+    return;
+
+  g_hash_table_unref (pool->strings);
+  g_mutex_clear (&pool->mutex);
+  g_free (pool);
+}
+
+/* Returns: (transfer full): the interned copy of STRING, to be given
+   back with _zanata_string_pool_release().  */
+const gchar *
+_zanata_string_pool_acquire (ZanataStringPool *pool,
+                             const gchar      *string)
+{
+  PoolEntry *entry;
+
+  if (string == NULL)
+    return NULL;
+
+  g_mutex_lock (&pool->mutex);
+  entry = g_hash_table_lookup (pool->strings, string);
+  if (entry != NULL)
+    entry->count++;
+  else
+    {
+      gsize length = strlen (string);
+
+      /* The string is stored in the entry itself, so that interning
+         costs a single allocation.  */
+      entry = g_malloc (G_STRUCT_OFFSET (PoolEntry, string) + length + 1);
+      entry->count = 1;
+      memcpy (entry->string, string, length + 1);
+      g_hash_table_insert (pool->strings, entry->string, entry);
+    }
+  g_mutex_unlock (&pool->mutex);
+
+  return entry->string;
+}
+
+void
+_zanata_string_pool_release (ZanataStringPool *pool,
+                             const gchar      *string)
+{
+  PoolEntry *entry;
+
+  if (string == NULL)
+    return;
+
+  g_mutex_lock (&pool->mutex);
+  entry = g_hash_table_lookup (pool->strings, string);
+  g_warn_if_fail (entry != NULL && entry->string == string);
+  if (entry != NULL && --entry->count == 0)
+    g_hash_table_remove (pool->strings, entry->string);
+  g_mutex_unlock (&pool->mutex);
+}
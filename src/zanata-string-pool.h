@@ -0,0 +1,30 @@
+#ifndef ZANATA_STRING_POOL_H
+#define ZANATA_STRING_POOL_H
+
+#include <glib.h>
+#include "zanata-session.h"
+
+G_BEGIN_DECLS
+
+/* A thread-safe pool of reference counted strings, so that values
+   repeated across decoded objects, such as iteration ids, are stored
+   once.  The pool itself is reference counted, since interned strings
+   may outlive the session which owns it.  */
+
+typedef struct _ZanataStringPool ZanataStringPool;
+
+ZanataStringPool *_zanata_string_pool_new     (void);
+ZanataStringPool *_zanata_string_pool_ref     (ZanataStringPool *pool);
+void              _zanata_string_pool_unref   (ZanataStringPool *pool);
+
+const gchar      *_zanata_string_pool_acquire (ZanataStringPool *pool,
+                                               const gchar      *string);
+void              _zanata_string_pool_release (ZanataStringPool *pool,
+                                               const gchar      *string);
+
+ZanataStringPool *_zanata_session_get_string_pool
+                                              (ZanataSession    *session);
+
+G_END_DECLS
+
+#endif  /* ZANATA_STRING_POOL_H */
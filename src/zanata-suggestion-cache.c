@@ -0,0 +1,185 @@
+#include "config.h"
+
+#include "zanata-suggestion-cache.h"
+
+#include <string.h>
+
+typedef struct _CacheEntry CacheEntry;
+
+struct _CacheEntry
+{
+  gchar *key;
+  GListModel *suggestions;
+  gint64 expires;
+  GList link;
+};
+
+struct _ZanataSuggestionCache
+{
+  GMutex mutex;
+  guint max_entries;
+  guint ttl;
+
+  GHashTable *entries;
+
+  /* Most recently used entries first.  The links are embedded in the
+     entries themselves.  */
+  GQueue order;
+
+  guint hits;
+  guint misses;
+};
+
+static void
+cache_entry_free (CacheEntry *entry)
+{
+  g_free (entry->key);
+  g_object_unref (entry->suggestions);
+  g_slice_free (CacheEntry, entry);
+}
+
+ZanataSuggestionCache *
+_zanata_suggestion_cache_new (guint max_entries,
+                              guint ttl)
+{
+  ZanataSuggestionCache *cache = g_new0 (ZanataSuggestionCache, 1);
+
+  g_mutex_init (&cache->mutex);
+  cache->max_entries = max_entries;
+  cache->ttl = ttl;
+  cache->entries = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                          NULL,
+                                          (GDestroyNotify) cache_entry_free);
+  g_queue_init (&cache->order);
+  return cache;
+}
+
+void
+_zanata_suggestion_cache_free (ZanataSuggestionCache *cache)
+{
+  g_hash_table_unref (cache->entries);
+  g_mutex_clear (&cache->mutex);
+  g_free (cache);
+}
+
+/* Must be called with the mutex held.  */
+static void
+remove_entry (ZanataSuggestionCache *cache,
+              CacheEntry            *entry)
+{
+  g_queue_unlink (&cache->order, &entry->link);
+  g_hash_table_remove (cache->entries, entry->key);
+}
+
+/* Must be called with the mutex held.  */
+static void
+evict (ZanataSuggestionCache *cache)
+{
+  while (cache->order.length > cache->max_entries)
+    remove_entry (cache, cache->order.tail->data);
+}
+
+void
+_zanata_suggestion_cache_set_limits (ZanataSuggestionCache *cache,
+                                     guint                  max_entries,
+                                     guint                  ttl)
+{
+  g_mutex_lock (&cache->mutex);
+  cache->max_entries = max_entries;
+  cache->ttl = ttl;
+  evict (cache);
+  g_mutex_unlock (&cache->mutex);
+}
+
+/* Each component is prefixed with its length, so that no choice of
+   separator can make two different lookups collide.  */
+gchar *
+_zanata_suggestion_cache_build_key (const gchar * const *query,
+                                    const gchar         *from_locale,
+                                    const gchar         *to_locale)
+{
+  GString *key = g_string_new (NULL);
+
+  g_string_append_printf (key, "%" G_GSIZE_FORMAT ":%s",
+                          strlen (from_locale), from_locale);
+  g_string_append_printf (key, "%" G_GSIZE_FORMAT ":%s",
+                          strlen (to_locale), to_locale);
+  for (; *query; query++)
+    g_string_append_printf (key, "%" G_GSIZE_FORMAT ":%s",
+                            strlen (*query), *query);
+
+  return g_string_free (key, FALSE);
+}
+
+/* Returns: (transfer full) (nullable): the cached suggestions for KEY,
+   or NULL if there is no fresh entry.  */
+GListModel *
+_zanata_suggestion_cache_lookup (ZanataSuggestionCache *cache,
+                                 const gchar           *key)
+{
+  CacheEntry *entry;
+  GListModel *suggestions = NULL;
+
+  g_mutex_lock (&cache->mutex);
+  entry = g_hash_table_lookup (cache->entries, key);
+  if (entry != NULL && entry->expires <= g_get_monotonic_time ())
+    {
+      remove_entry (cache, entry);
+      entry = NULL;
+    }
+
+  if (entry != NULL)
+    {
+      g_queue_unlink (&cache->order, &entry->link);
+      g_queue_push_head_link (&cache->order, &entry->link);
+      suggestions = g_object_ref (entry->suggestions);
+      cache->hits++;
+    }
+  else
+    cache->misses++;
+  g_mutex_unlock (&cache->mutex);
+
+  return suggestions;
+}
+
+void
+_zanata_suggestion_cache_insert (ZanataSuggestionCache *cache,
+                                 const gchar           *key,
+                                 GListModel            *suggestions)
+{
+  CacheEntry *entry;
+
+  g_mutex_lock (&cache->mutex);
+  if (cache->max_entries == 0 || cache->ttl == 0)
+    {
+      g_mutex_unlock (&cache->mutex);
+      return;
+    }
+
+  entry = g_hash_table_lookup (cache->entries, key);
+  if (entry != NULL)
+    remove_entry (cache, entry);
+
+  entry = g_slice_new0 (CacheEntry);
+  entry->key = g_strdup (key);
+  entry->suggestions = g_object_ref (suggestions);
+  entry->expires = g_get_monotonic_time () + cache->ttl * G_TIME_SPAN_SECOND;
+  entry->link.data = entry;
+  g_hash_table_insert (cache->entries, entry->key, entry);
+  g_queue_push_head_link (&cache->order, &entry->link);
+  evict (cache);
+  g_mutex_unlock (&cache->mutex);
+}
+
+void
+_zanata_suggestion_cache_get_stats (ZanataSuggestionCache *cache,
+                                    guint                 *hits,
+                                    guint                 *misses)
+{
+  g_mutex_lock (&cache->mutex);
+  if (hits)
+    *hits = cache->hits;
+  if (misses)
+    *misses = cache->misses;
+  g_mutex_unlock (&cache->mutex);
+}
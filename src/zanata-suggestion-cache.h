@@ -0,0 +1,43 @@
+#ifndef ZANATA_SUGGESTION_CACHE_H
+#define ZANATA_SUGGESTION_CACHE_H
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+/* A bounded least-recently-used cache of suggestion lookups.  Entries
+   are keyed by the locale pair and the whole query, since the query
+   strings of a lookup are the plural forms of a single text flow and
+   are matched together by the server.  */
+
+typedef struct _ZanataSuggestionCache ZanataSuggestionCache;
+
+ZanataSuggestionCache *_zanata_suggestion_cache_new
+                                          (guint                  max_entries,
+                                           guint                  ttl);
+void                   _zanata_suggestion_cache_free
+                                          (ZanataSuggestionCache *cache);
+void                   _zanata_suggestion_cache_set_limits
+                                          (ZanataSuggestionCache *cache,
+                                           guint                  max_entries,
+                                           guint                  ttl);
+
+gchar                 *_zanata_suggestion_cache_build_key
+                                          (const gchar * const   *query,
+                                           const gchar           *from_locale,
+                                           const gchar           *to_locale);
+GListModel            *_zanata_suggestion_cache_lookup
+                                          (ZanataSuggestionCache *cache,
+                                           const gchar           *key);
+void                   _zanata_suggestion_cache_insert
+                                          (ZanataSuggestionCache *cache,
+                                           const gchar           *key,
+                                           GListModel            *suggestions);
+void                   _zanata_suggestion_cache_get_stats
+                                          (ZanataSuggestionCache *cache,
+                                           guint                 *hits,
+                                           guint                 *misses);
+
+G_END_DECLS
+
+#endif  /* ZANATA_SUGGESTION_CACHE_H */
@@ -0,0 +1,220 @@
+#include "config.h"
+
+#include "zanata-suggestion-list.h"
+#include "zanata-suggestion.h"
+
+/* The strings of a response, shared by the list and the suggestions
+   created from it, which may outlive the list.  The string vector
+   holds the contents of each suggestion as two NULL-terminated runs,
+   pointing into the chunk.  */
+
+typedef struct _Arena Arena;
+
+struct _Arena
+{
+  gint ref_count;
+  GStringChunk *chunk;
+  GPtrArray *strings;
+};
+
+typedef struct _Record Record;
+
+struct _Record
+{
+  /* Indices into the string vector of the source and target
+     contents.  */
+  guint source;
+  guint target;
+};
+
+struct _ZanataSuggestionList
+{
+  GObject parent_object;
+  Arena *arena;
+  GArray *records;
+
+  /* Suggestions created so far, by position.  */
+  GMutex suggestions_lock;
+  GPtrArray *suggestions;
+};
+
+static void zanata_suggestion_list_list_model_init (GListModelInterface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (ZanataSuggestionList, zanata_suggestion_list,
+                         G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (G_TYPE_LIST_MODEL,
+                                                zanata_suggestion_list_list_model_init))
+
+static Arena *
+arena_ref (Arena *arena)
+{
+  g_atomic_int_inc (&arena->ref_count);
+  return arena;
+}
+
+static void
+arena_unref (Arena *arena)
+{
+  if (!g_atomic_int_dec_and_test (&arena->ref_count))
+    return;
+
+  g_ptr_array_unref (arena->strings);
+  g_string_chunk_free (arena->chunk);
+  g_slice_free (Arena, arena);
+}
+
+static void
+zanata_suggestion_list_dispose (GObject *object)
+{
+  ZanataSuggestionList *self = ZANATA_SUGGESTION_LIST (object);
+
+  g_ptr_array_set_size (self->suggestions, 0);
+
+  G_OBJECT_CLASS (zanata_suggestion_list_parent_class)->dispose (object);
+}
+
+static void
+zanata_suggestion_list_finalize (GObject *object)
+{
+  ZanataSuggestionList *self = ZANATA_SUGGESTION_LIST (object);
+
+  g_ptr_array_unref (self->suggestions);
+  g_mutex_clear (&self->suggestions_lock);
+  g_array_unref (self->records);
+  arena_unref (self->arena);
+
+  G_OBJECT_CLASS (zanata_suggestion_list_parent_class)->finalize (object);
+}
+
+static void
+zanata_suggestion_list_class_init (ZanataSuggestionListClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->dispose = zanata_suggestion_list_dispose;
+  object_class->finalize = zanata_suggestion_list_finalize;
+}
+
+static void
+zanata_suggestion_list_init (ZanataSuggestionList *self)
+{
+  self->arena = g_slice_new (Arena);
+  self->arena->ref_count = 1;
+  self->arena->chunk = g_string_chunk_new (4096);
+  self->arena->strings = g_ptr_array_new ();
+  self->records = g_array_new (FALSE, FALSE, sizeof (Record));
+  g_mutex_init (&self->suggestions_lock);
+  self->suggestions = g_ptr_array_new_with_free_func (g_object_unref);
+}
+
+static GType
+zanata_suggestion_list_get_item_type (GListModel *list)
+{
+  return ZANATA_TYPE_SUGGESTION;
+}
+
+static guint
+zanata_suggestion_list_get_n_items (GListModel *list)
+{
+  ZanataSuggestionList *self = ZANATA_SUGGESTION_LIST (list);
+
+  return self->records->len;
+}
+
+static gpointer
+zanata_suggestion_list_get_item (GListModel *list,
+                                 guint       position)
+{
+  ZanataSuggestionList *self = ZANATA_SUGGESTION_LIST (list);
+  ZanataSuggestion *suggestion;
+
+  if (position >= self->records->len)
+    return NULL;
+
+  g_mutex_lock (&self->suggestions_lock);
+  suggestion = g_ptr_array_index (self->suggestions, position);
+  if (suggestion == NULL)
+    {
+      Record *record = &g_array_index (self->records, Record, position);
+      gchar **strings = (gchar **) self->arena->strings->pdata;
+
+      suggestion =
+        _zanata_suggestion_new_borrowed (arena_ref (self->arena),
+                                         (GDestroyNotify) arena_unref,
+                                         strings + record->source,
+                                         strings + record->target);
+      g_ptr_array_index (self->suggestions, position) = suggestion;
+    }
+  g_object_ref (suggestion);
+  g_mutex_unlock (&self->suggestions_lock);
+
+  return suggestion;
+}
+
+static void
+zanata_suggestion_list_list_model_init (GListModelInterface *iface)
+{
+  iface->get_item_type = zanata_suggestion_list_get_item_type;
+  iface->get_n_items = zanata_suggestion_list_get_n_items;
+  iface->get_item = zanata_suggestion_list_get_item;
+}
+
+static void
+add_contents (Arena     *arena,
+              JsonArray *array)
+{
+  guint length, i;
+
+  length = json_array_get_length (array);
+  for (i = 0; i < length; i++)
+    {
+      const gchar *value = json_array_get_string_element (array, i);
+      if (value)
+        g_ptr_array_add (arena->strings,
+                         g_string_chunk_insert (arena->chunk, value));
+    }
+  g_ptr_array_add (arena->strings, NULL);
+}
+
+static void
+collect_suggestions (JsonArray *array,
+                     guint      index_,
+                     JsonNode  *element_node,
+                     gpointer   user_data)
+{
+  ZanataSuggestionList *list = user_data;
+  JsonObject *object;
+  JsonArray *source_array, *target_array;
+  Record record;
+
+  if (json_node_get_node_type (element_node) != JSON_NODE_OBJECT)
+    return;
+
+  object = json_node_get_object (element_node);
+  source_array = json_object_get_array_member (object, "sourceContents");
+  if (!source_array)
+    return;
+
+  target_array = json_object_get_array_member (object, "targetContents");
+  if (!target_array)
+    return;
+
+  record.source = list->arena->strings->len;
+  add_contents (list->arena, source_array);
+  record.target = list->arena->strings->len;
+  add_contents (list->arena, target_array);
+  g_array_append_val (list->records, record);
+}
+
+/* Decodes the suggestions held by ARRAY, as returned by the
+   /rest/suggestions endpoint.  */
+ZanataSuggestionList *
+_zanata_suggestion_list_new_from_array (JsonArray *array)
+{
+  ZanataSuggestionList *list;
+
+  list = g_object_new (ZANATA_TYPE_SUGGESTION_LIST, NULL);
+  json_array_foreach_element (array, collect_suggestions, list);
+  g_ptr_array_set_size (list->suggestions, list->records->len);
+  return list;
+}
@@ -0,0 +1,23 @@
+#ifndef ZANATA_SUGGESTION_LIST_H
+#define ZANATA_SUGGESTION_LIST_H
+
+#include <gio/gio.h>
+#include <json-glib/json-glib.h>
+
+G_BEGIN_DECLS
+
+/* A read-only #GListModel of #ZanataSuggestion decoded from a single
+   response.  All the strings are copied into one arena and freed
+   together; suggestion objects are only created when requested.  */
+
+#define ZANATA_TYPE_SUGGESTION_LIST (zanata_suggestion_list_get_type ())
+
+G_DECLARE_FINAL_TYPE (ZanataSuggestionList, zanata_suggestion_list,
+                      ZANATA, SUGGESTION_LIST, GObject)
+
+ZanataSuggestionList *_zanata_suggestion_list_new_from_array
+                                             (JsonArray *array);
+
+G_END_DECLS
+
+#endif  /* ZANATA_SUGGESTION_LIST_H */
@@ -7,6 +7,11 @@ struct _ZanataSuggestion
   GObject parent;
   gchar **source_contents;
   gchar **target_contents;
+
+  /* If set, the contents are borrowed from this storage instead of
+     being owned by the suggestion.  */
+  gpointer owner;
+  GDestroyNotify owner_release;
 };
 
 G_DEFINE_TYPE (ZanataSuggestion, zanata_suggestion, G_TYPE_OBJECT)
@@ -25,6 +30,13 @@ zanata_suggestion_dispose (GObject *object)
 {
   ZanataSuggestion *self = ZANATA_SUGGESTION (object);
 
+  if (self->owner)
+    {
+      self->source_contents = NULL;
+      self->target_contents = NULL;
+      self->owner_release (self->owner);
+      self->owner = NULL;
+    }
   g_clear_pointer (&self->source_contents, g_strfreev);
   g_clear_pointer (&self->target_contents, g_strfreev);
 
@@ -108,3 +120,22 @@ static void
 zanata_suggestion_init (ZanataSuggestion *self)
 {
 }
+
+/* Creates a suggestion pointing to contents held by OWNER, which is
+   released with OWNER_RELEASE along with the suggestion.  Both arrays
+   must be NULL-terminated.  */
+ZanataSuggestion *
+_zanata_suggestion_new_borrowed (gpointer        owner,
+                                 GDestroyNotify  owner_release,
+                                 gchar         **source_contents,
+                                 gchar         **target_contents)
+{
+  ZanataSuggestion *suggestion;
+
+  suggestion = g_object_new (ZANATA_TYPE_SUGGESTION, NULL);
+  suggestion->owner = owner;
+  suggestion->owner_release = owner_release;
+  suggestion->source_contents = source_contents;
+  suggestion->target_contents = target_contents;
+  return suggestion;
+}
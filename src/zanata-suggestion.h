@@ -10,6 +10,12 @@ G_BEGIN_DECLS
 G_DECLARE_FINAL_TYPE (ZanataSuggestion, zanata_suggestion,
                       ZANATA, SUGGESTION, GObject)
 
+ZanataSuggestion *_zanata_suggestion_new_borrowed
+                                         (gpointer         owner,
+                                          GDestroyNotify   owner_release,
+                                          gchar          **source_contents,
+                                          gchar          **target_contents);
+
 G_END_DECLS
 
 #endif  /* ZANATA_SUGGESTION_H */
@@ -0,0 +1,301 @@
+#include "config.h"
+
+#include "zanata-text-flow-target.h"
+#include "zanata-enumtypes.h"
+#include "zanata-enumdecode.h"
+
+struct _ZanataTextFlowTarget
+{
+  GObject parent_object;
+  gchar *res_id;
+  ZanataContentState state;
+  gchar **contents;
+  gint revision;
+  gint text_flow_revision;
+
+  /* The translator comment, from the "comment" extension.  */
+  gchar *comment;
+};
+
+G_DEFINE_TYPE (ZanataTextFlowTarget, zanata_text_flow_target, G_TYPE_OBJECT)
+
+enum {
+  PROP_0,
+  PROP_RES_ID,
+  PROP_STATE,
+  PROP_CONTENTS,
+  PROP_REVISION,
+  PROP_TEXT_FLOW_REVISION,
+  PROP_COMMENT,
+  LAST_PROP
+};
+
+static GParamSpec *text_flow_target_pspecs[LAST_PROP] = { 0 };
+
+static void
+zanata_text_flow_target_get_property (GObject    *object,
+                                      guint       prop_id,
+                                      GValue     *value,
+                                      GParamSpec *pspec)
+{
+  ZanataTextFlowTarget *self = ZANATA_TEXT_FLOW_TARGET (object);
+
+  switch (prop_id)
+    {
+    case PROP_RES_ID:
+      g_value_set_string (value, self->res_id);
+      break;
+
+    case PROP_STATE:
+      g_value_set_enum (value, self->state);
+      break;
+
+    case PROP_CONTENTS:
+      g_value_set_boxed (value, self->contents);
+      break;
+
+    case PROP_REVISION:
+      g_value_set_int (value, self->revision);
+      break;
+
+    case PROP_TEXT_FLOW_REVISION:
+      g_value_set_int (value, self->text_flow_revision);
+      break;
+
+    case PROP_COMMENT:
+      g_value_set_string (value, self->comment);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+zanata_text_flow_target_finalize (GObject *object)
+{
+  ZanataTextFlowTarget *self = ZANATA_TEXT_FLOW_TARGET (object);
+
+  g_free (self->res_id);
+  g_strfreev (self->contents);
+  g_free (self->comment);
+
+  G_OBJECT_CLASS (zanata_text_flow_target_parent_class)->finalize (object);
+}
+
+static void
+zanata_text_flow_target_class_init (ZanataTextFlowTargetClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->get_property = zanata_text_flow_target_get_property;
+  object_class->finalize = zanata_text_flow_target_finalize;
+
+  text_flow_target_pspecs[PROP_RES_ID] =
+    g_param_spec_string ("res-id",
+                         "Resource ID",
+                         "The ID of the source text flow",
+                         NULL,
+                         G_PARAM_READABLE);
+  text_flow_target_pspecs[PROP_STATE] =
+    g_param_spec_enum ("state",
+                       "State",
+                       "The review state of the translation",
+                       ZANATA_TYPE_CONTENT_STATE,
+                       ZANATA_CONTENT_STATE_UNKNOWN,
+                       G_PARAM_READABLE);
+  text_flow_target_pspecs[PROP_CONTENTS] =
+    g_param_spec_boxed ("contents",
+                        "Contents",
+                        "The translated contents, one per plural form",
+                        G_TYPE_STRV,
+                        G_PARAM_READABLE);
+  text_flow_target_pspecs[PROP_REVISION] =
+    g_param_spec_int ("revision",
+                      "Revision",
+                      "The revision of the translation",
+                      0, G_MAXINT, 0,
+                      G_PARAM_READABLE);
+  text_flow_target_pspecs[PROP_TEXT_FLOW_REVISION] =
+    g_param_spec_int ("text-flow-revision",
+                      "Text flow revision",
+                      "The revision of the source text flow translated",
+                      0, G_MAXINT, 0,
+                      G_PARAM_READABLE);
+  text_flow_target_pspecs[PROP_COMMENT] =
+    g_param_spec_string ("comment",
+                         "Comment",
+                         "The translator comment",
+                         NULL,
+                         G_PARAM_READABLE);
+  g_object_class_install_properties (object_class, LAST_PROP,
+                                     text_flow_target_pspecs);
+}
+
+static void
+zanata_text_flow_target_init (ZanataTextFlowTarget *self)
+{
+}
+
+static gint
+get_int_member (JsonObject  *object,
+                const gchar *name)
+{
+  JsonNode *node = json_object_get_member (object, name);
+
+  if (node == NULL || json_node_get_value_type (node) != G_TYPE_INT64)
+    return 0;
+  return CLAMP (json_node_get_int (node), 0, G_MAXINT);
+}
+
+static const gchar *
+get_string_member (JsonObject  *object,
+                   const gchar *name)
+{
+  JsonNode *node = json_object_get_member (object, name);
+
+  if (node == NULL || json_node_get_value_type (node) != G_TYPE_STRING)
+    return NULL;
+  return json_node_get_string (node);
+}
+
+static gchar **
+collect_contents (JsonObject *object)
+{
+  JsonNode *node;
+  JsonArray *array;
+  gchar **contents;
+  guint length, i, j;
+
+  node = json_object_get_member (object, "contents");
+  if (node == NULL || !JSON_NODE_HOLDS_ARRAY (node))
+    {
+      const gchar *content = get_string_member (object, "content");
+
+      contents = g_new0 (gchar *, 2);
+      if (content != NULL)
+        contents[0] = g_strdup (content);
+      return contents;
+    }
+
+  array = json_node_get_array (node);
+  length = json_array_get_length (array);
+  contents = g_new0 (gchar *, length + 1);
+  for (i = 0, j = 0; i < length; i++)
+    {
+      JsonNode *element = json_array_get_element (array, i);
+
+      if (json_node_get_value_type (element) == G_TYPE_STRING)
+        contents[j++] = g_strdup (json_node_get_string (element));
+    }
+  return contents;
+}
+
+static gchar *
+find_comment (JsonObject *object)
+{
+  JsonNode *node;
+  JsonArray *array;
+  guint length, i;
+
+  node = json_object_get_member (object, "extensions");
+  if (node == NULL || !JSON_NODE_HOLDS_ARRAY (node))
+    return NULL;
+
+  array = json_node_get_array (node);
+  length = json_array_get_length (array);
+  for (i = 0; i < length; i++)
+    {
+      JsonNode *element = json_array_get_element (array, i);
+      JsonObject *extension;
+
+      if (!JSON_NODE_HOLDS_OBJECT (element))
+        continue;
+
+      extension = json_node_get_object (element);
+      if (g_strcmp0 (get_string_member (extension, "object-type"),
+                     "comment") == 0)
+        return g_strdup (get_string_member (extension, "value"));
+    }
+  return NULL;
+}
+
+/* Decodes an element of the "textFlowTargets" array of a translation
+   resource, or returns NULL if it has no resource ID.  */
+ZanataTextFlowTarget *
+_zanata_text_flow_target_new_from_object (JsonObject *object)
+{
+  ZanataTextFlowTarget *target;
+  const gchar *res_id;
+
+  res_id = get_string_member (object, "resId");
+  if (!res_id)
+    return NULL;
+
+  target = g_object_new (ZANATA_TYPE_TEXT_FLOW_TARGET, NULL);
+  target->res_id = g_strdup (res_id);
+  target->state =
+    _zanata_content_state_from_nick (get_string_member (object, "state"),
+                                     ZANATA_CONTENT_STATE_UNKNOWN);
+  target->contents = collect_contents (object);
+  target->revision = get_int_member (object, "revision");
+  target->text_flow_revision = get_int_member (object, "textFlowRevision");
+  target->comment = find_comment (object);
+  return target;
+}
+
+/**
+ * zanata_text_flow_target_get_res_id:
+ * @target: a #ZanataTextFlowTarget
+ *
+ * Returns: the ID of the source text flow translated by @target
+ */
+const gchar *
+zanata_text_flow_target_get_res_id (ZanataTextFlowTarget *target)
+{
+  g_return_val_if_fail (ZANATA_IS_TEXT_FLOW_TARGET (target), NULL);
+  return target->res_id;
+}
+
+/**
+ * zanata_text_flow_target_get_state:
+ * @target: a #ZanataTextFlowTarget
+ *
+ * Returns: the review state of @target
+ */
+ZanataContentState
+zanata_text_flow_target_get_state (ZanataTextFlowTarget *target)
+{
+  g_return_val_if_fail (ZANATA_IS_TEXT_FLOW_TARGET (target),
+                        ZANATA_CONTENT_STATE_UNKNOWN);
+  return target->state;
+}
+
+/**
+ * zanata_text_flow_target_get_contents:
+ * @target: a #ZanataTextFlowTarget
+ *
+ * Returns: (transfer none) (array zero-terminated=1): the translated
+ * contents, one per plural form
+ */
+const gchar * const *
+zanata_text_flow_target_get_contents (ZanataTextFlowTarget *target)
+{
+  g_return_val_if_fail (ZANATA_IS_TEXT_FLOW_TARGET (target), NULL);
+  return (const gchar * const *) target->contents;
+}
+
+/**
+ * zanata_text_flow_target_get_comment:
+ * @target: a #ZanataTextFlowTarget
+ *
+ * Returns: (nullable): the translator comment, if the resource was
+ * requested with the gettext extension and the target has one
+ */
+const gchar *
+zanata_text_flow_target_get_comment (ZanataTextFlowTarget *target)
+{
+  g_return_val_if_fail (ZANATA_IS_TEXT_FLOW_TARGET (target), NULL);
+  return target->comment;
+}
@@ -0,0 +1,29 @@
+#ifndef ZANATA_TEXT_FLOW_TARGET_H
+#define ZANATA_TEXT_FLOW_TARGET_H
+
+#include <glib-object.h>
+#include <json-glib/json-glib.h>
+#include "zanata-enums.h"
+
+G_BEGIN_DECLS
+
+#define ZANATA_TYPE_TEXT_FLOW_TARGET (zanata_text_flow_target_get_type ())
+
+G_DECLARE_FINAL_TYPE (ZanataTextFlowTarget, zanata_text_flow_target,
+                      ZANATA, TEXT_FLOW_TARGET, GObject)
+
+const gchar          *zanata_text_flow_target_get_res_id
+                                        (ZanataTextFlowTarget *target);
+ZanataContentState    zanata_text_flow_target_get_state
+                                        (ZanataTextFlowTarget *target);
+const gchar * const  *zanata_text_flow_target_get_contents
+                                        (ZanataTextFlowTarget *target);
+const gchar          *zanata_text_flow_target_get_comment
+                                        (ZanataTextFlowTarget *target);
+
+ZanataTextFlowTarget *_zanata_text_flow_target_new_from_object
+                                        (JsonObject           *object);
+
+G_END_DECLS
+
+#endif  /* ZANATA_TEXT_FLOW_TARGET_H */
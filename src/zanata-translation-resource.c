@@ -0,0 +1,300 @@
+#include "config.h"
+
+#include "zanata-translation-resource.h"
+#include "zanata-json-stream.h"
+#include "zanata-array-model.h"
+
+struct _ZanataTranslationResource
+{
+  GObject parent_object;
+  ZanataJsonStream *json;
+
+  /* The resource-level extensions, once they have been read.  */
+  JsonNode *extensions;
+};
+
+G_DEFINE_TYPE (ZanataTranslationResource, zanata_translation_resource,
+               G_TYPE_OBJECT)
+
+enum {
+  TARGET_RECEIVED,
+  LAST_SIGNAL
+};
+
+static guint translation_resource_signals[LAST_SIGNAL] = { 0 };
+
+static void
+zanata_translation_resource_finalize (GObject *object)
+{
+  ZanataTranslationResource *self = ZANATA_TRANSLATION_RESOURCE (object);
+
+  g_clear_pointer (&self->json, _zanata_json_stream_free);
+  g_clear_pointer (&self->extensions, json_node_free);
+
+  G_OBJECT_CLASS (zanata_translation_resource_parent_class)->finalize (object);
+}
+
+static void
+zanata_translation_resource_class_init (ZanataTranslationResourceClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->finalize = zanata_translation_resource_finalize;
+
+  /**
+   * ZanataTranslationResource::target-received:
+   * @resource: a #ZanataTranslationResource
+   * @target: a #ZanataTextFlowTarget
+   *
+   * Emitted for each text flow target as soon as it is decoded.
+   */
+  translation_resource_signals[TARGET_RECEIVED] =
+    g_signal_new ("target-received",
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST,
+                  0,
+                  NULL, NULL,
+                  NULL,
+                  G_TYPE_NONE, 1,
+                  ZANATA_TYPE_TEXT_FLOW_TARGET);
+}
+
+static void
+zanata_translation_resource_init (ZanataTranslationResource *self)
+{
+}
+
+/* Creates a reader for the translation resource in INPUT.  The text
+   flow targets are decoded one at a time as the response is
+   downloaded, so that only the batch being returned is held in
+   memory.  */
+ZanataTranslationResource *
+_zanata_translation_resource_new (GInputStream *input)
+{
+  static const gchar * const streamed_members[] =
+    { "textFlowTargets", NULL };
+  ZanataTranslationResource *resource;
+
+  resource = g_object_new (ZANATA_TYPE_TRANSLATION_RESOURCE, NULL);
+  resource->json = _zanata_json_stream_new (input, streamed_members);
+  return resource;
+}
+
+typedef struct _NextData NextData;
+
+struct _NextData
+{
+  ZanataTranslationResource *resource;
+  GPtrArray *targets;
+};
+
+static void
+next_data_free (NextData *data)
+{
+  g_clear_pointer (&data->targets, g_ptr_array_unref);
+  g_slice_free (NextData, data);
+}
+
+static gboolean
+next_take_node (const gchar *member,
+                JsonNode    *node,
+                gpointer     user_data)
+{
+  NextData *data = user_data;
+  ZanataTranslationResource *resource = data->resource;
+  ZanataTextFlowTarget *target;
+
+  if (g_strcmp0 (member, "extensions") == 0)
+    {
+      g_clear_pointer (&resource->extensions, json_node_free);
+      resource->extensions = json_node_copy (node);
+      return FALSE;
+    }
+
+  if (g_strcmp0 (member, "textFlowTargets") != 0
+      || !JSON_NODE_HOLDS_OBJECT (node))
+    return FALSE;
+
+  target =
+    _zanata_text_flow_target_new_from_object (json_node_get_object (node));
+  if (!target)
+    return FALSE;
+
+  g_ptr_array_add (data->targets, target);
+  g_signal_emit (resource, translation_resource_signals[TARGET_RECEIVED], 0,
+                 target);
+  return TRUE;
+}
+
+static void
+next_read_cb (GObject      *source_object,
+              GAsyncResult *res,
+              gpointer      user_data)
+{
+  GTask *task = G_TASK (user_data);
+  ZanataTranslationResource *resource = g_task_get_source_object (task);
+  NextData *data = g_task_get_task_data (task);
+  GError *error = NULL;
+  ZanataArrayModel *model;
+
+  if (!_zanata_json_stream_read_finish (resource->json, res, &error))
+    {
+      g_task_return_error (task, error);
+      g_object_unref (task);
+      return;
+    }
+
+  model = _zanata_array_model_new_take (ZANATA_TYPE_TEXT_FLOW_TARGET,
+                                        data->targets);
+  data->targets = NULL;
+  g_task_return_pointer (task, model, g_object_unref);
+  g_object_unref (task);
+}
+
+static void
+next_start (ZanataTranslationResource *resource,
+            guint                      max_targets,
+            GCancellable              *cancellable,
+            GAsyncReadyCallback        callback,
+            gpointer                   user_data)
+{
+  GTask *task;
+  NextData *data;
+
+  task = g_task_new (resource, cancellable, callback, user_data);
+
+  data = g_slice_new0 (NextData);
+  data->resource = resource;
+  data->targets = g_ptr_array_new_full (MIN (max_targets, 1024),
+                                        g_object_unref);
+  g_task_set_task_data (task, data, (GDestroyNotify) next_data_free);
+
+  _zanata_json_stream_read_async (resource->json,
+                                  max_targets,
+                                  next_take_node,
+                                  data,
+                                  cancellable,
+                                  next_read_cb,
+                                  task);
+}
+
+/**
+ * zanata_translation_resource_next_async:
+ * @resource: a #ZanataTranslationResource
+ * @max_targets: the maximum number of text flow targets to return
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: a #GAsyncReadyCallback
+ * @user_data: (nullable): a user data
+ *
+ * Starts reading up to @max_targets text flow targets from @resource.
+ * Targets are decoded as the response is downloaded, so that a large
+ * document can be processed in batches of bounded size.  This
+ * operation is asynchronous and shall be finished with
+ * zanata_translation_resource_next_finish().
+ */
+void
+zanata_translation_resource_next_async (ZanataTranslationResource *resource,
+                                        guint                      max_targets,
+                                        GCancellable              *cancellable,
+                                        GAsyncReadyCallback        callback,
+                                        gpointer                   user_data)
+{
+  g_return_if_fail (ZANATA_IS_TRANSLATION_RESOURCE (resource));
+  g_return_if_fail (max_targets > 0);
+
+  next_start (resource, max_targets, cancellable, callback, user_data);
+}
+
+/**
+ * zanata_translation_resource_next_finish:
+ * @resource: a #ZanataTranslationResource
+ * @result: a #GAsyncResult
+ * @error: error location
+ *
+ * Finishes zanata_translation_resource_next_async() operation.  An
+ * empty model returned without an error means that the end of the
+ * resource has been reached.
+ *
+ * Returns: (transfer full): a #GListModel of #ZanataTextFlowTarget
+ */
+GListModel *
+zanata_translation_resource_next_finish (ZanataTranslationResource  *resource,
+                                         GAsyncResult               *result,
+                                         GError                    **error)
+{
+  g_return_val_if_fail (g_task_is_valid (result, resource), NULL);
+
+  return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+/**
+ * zanata_translation_resource_next_target_async:
+ * @resource: a #ZanataTranslationResource
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: a #GAsyncReadyCallback
+ * @user_data: (nullable): a user data
+ *
+ * Starts reading the next text flow target from @resource, returning
+ * as soon as it has been downloaded.  This operation is asynchronous
+ * and shall be finished with
+ * zanata_translation_resource_next_target_finish().
+ */
+void
+zanata_translation_resource_next_target_async (ZanataTranslationResource *resource,
+                                               GCancellable              *cancellable,
+                                               GAsyncReadyCallback        callback,
+                                               gpointer                   user_data)
+{
+  g_return_if_fail (ZANATA_IS_TRANSLATION_RESOURCE (resource));
+
+  next_start (resource, 1, cancellable, callback, user_data);
+}
+
+/**
+ * zanata_translation_resource_next_target_finish:
+ * @resource: a #ZanataTranslationResource
+ * @result: a #GAsyncResult
+ * @error: error location
+ *
+ * Finishes zanata_translation_resource_next_target_async() operation.
+ * %NULL returned without an error means that the end of the resource
+ * has been reached.
+ *
+ * Returns: (transfer full) (nullable): a #ZanataTextFlowTarget
+ */
+ZanataTextFlowTarget *
+zanata_translation_resource_next_target_finish (ZanataTranslationResource  *resource,
+                                                GAsyncResult               *result,
+                                                GError                    **error)
+{
+  GListModel *targets;
+  ZanataTextFlowTarget *target = NULL;
+
+  g_return_val_if_fail (g_task_is_valid (result, resource), NULL);
+
+  targets = g_task_propagate_pointer (G_TASK (result), error);
+  if (!targets)
+    return NULL;
+
+  if (g_list_model_get_n_items (targets) > 0)
+    target = g_list_model_get_item (targets, 0);
+  g_object_unref (targets);
+  return target;
+}
+
+/**
+ * zanata_translation_resource_get_extensions:
+ * @resource: a #ZanataTranslationResource
+ *
+ * Returns the resource-level extensions, such as the gettext header.
+ * These may follow the text flow targets in the response, so they are
+ * only available once the targets before them have been read.
+ *
+ * Returns: (transfer none) (nullable): a #JsonNode holding an array
+ */
+JsonNode *
+zanata_translation_resource_get_extensions (ZanataTranslationResource *resource)
+{
+  g_return_val_if_fail (ZANATA_IS_TRANSLATION_RESOURCE (resource), NULL);
+  return resource->extensions;
+}
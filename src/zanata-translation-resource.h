@@ -0,0 +1,46 @@
+#ifndef ZANATA_TRANSLATION_RESOURCE_H
+#define ZANATA_TRANSLATION_RESOURCE_H
+
+#include <gio/gio.h>
+#include <json-glib/json-glib.h>
+#include "zanata-text-flow-target.h"
+
+G_BEGIN_DECLS
+
+#define ZANATA_TYPE_TRANSLATION_RESOURCE (zanata_translation_resource_get_type ())
+
+G_DECLARE_FINAL_TYPE (ZanataTranslationResource, zanata_translation_resource,
+                      ZANATA, TRANSLATION_RESOURCE, GObject)
+
+void        zanata_translation_resource_next_async
+                                  (ZanataTranslationResource *resource,
+                                   guint                      max_targets,
+                                   GCancellable              *cancellable,
+                                   GAsyncReadyCallback        callback,
+                                   gpointer                   user_data);
+GListModel *zanata_translation_resource_next_finish
+                                  (ZanataTranslationResource *resource,
+                                   GAsyncResult              *result,
+                                   GError                   **error);
+
+void        zanata_translation_resource_next_target_async
+                                  (ZanataTranslationResource *resource,
+                                   GCancellable              *cancellable,
+                                   GAsyncReadyCallback        callback,
+                                   gpointer                   user_data);
+ZanataTextFlowTarget *
+            zanata_translation_resource_next_target_finish
+                                  (ZanataTranslationResource *resource,
+                                   GAsyncResult              *result,
+                                   GError                   **error);
+
+JsonNode   *zanata_translation_resource_get_extensions
+                                  (ZanataTranslationResource *resource);
+
+ZanataTranslationResource *
+            _zanata_translation_resource_new
+                                  (GInputStream              *input);
+
+G_END_DECLS
+
+#endif  /* ZANATA_TRANSLATION_RESOURCE_H */
@@ -1,10 +1,17 @@
 #ifndef ZANATA_H
 #define ZANATA_H
 
+#include <zanata/zanata-array-model.h>
 #include <zanata/zanata-authorizer.h>
 #include <zanata/zanata-enums.h>
 #include <zanata/zanata-enumtypes.h>
 #include <zanata/zanata-file-authorizer.h>
+#include <zanata/zanata-mirror.h>
+#include <zanata/zanata-project-catalog.h>
+#include <zanata/zanata-project-stream.h>
+#include <zanata/zanata-request.h>
 #include <zanata/zanata-suggestion.h>
+#include <zanata/zanata-text-flow-target.h>
+#include <zanata/zanata-translation-resource.h>
 
 #endif  /* ZANATA_H */
@@ -0,0 +1,54 @@
+const Zanata = imports.gi.Zanata;
+const Gio = imports.gi.Gio;
+const GLib = imports.gi.GLib;
+
+let key_file = new GLib.KeyFile();
+key_file.load_from_file(GLib.build_filenamev([GLib.get_user_config_dir(),
+                                              'zanata.ini']),
+                        GLib.KeyFileFlags.NONE);
+
+let authorizer = new Zanata.KeyFileAuthorizer({ key_file: key_file });
+
+let session = new Zanata.Session({ authorizer: authorizer,
+                                   domain: 'translate_zanata_org' });
+
+let loop = GLib.MainLoop.new(null, false);
+let directory = GLib.dir_make_tmp('zanata-mirror-XXXXXX');
+
+function mirrorIteration(iteration) {
+    let mirror = new Zanata.Mirror({ iteration: iteration,
+                                     documents: ['coala'],
+                                     locales: ['de-DE', 'fr', 'ja'],
+                                     max_concurrency: 2 });
+    mirror.connect('progress', function (m, completed, total) {
+        print(completed + '/' + total);
+    });
+    mirror.connect('item-failed', function (m, document, locale, error) {
+        print([document, locale, error.message]);
+    });
+    mirror.run_async(function (m, document, locale) {
+        let path = GLib.build_filenamev([directory,
+                                         document + '.' + locale + '.json']);
+        let file = Gio.File.new_for_path(path);
+        return file.replace(null, false, Gio.FileCreateFlags.NONE, null);
+    }, null, function (m, res, d) {
+        try {
+            m.run_finish(res);
+        } catch (e) {
+            print(e.message);
+        }
+        print(directory);
+        loop.quit();
+    });
+}
+
+session.get_project('coala', null,
+                    function (s, res, d) {
+                        let project = s.get_project_finish(res);
+                        project.get_iterations(null, function (p, res, d) {
+                            let result = p.get_iterations_finish(res);
+                            mirrorIteration(result[result.length - 1]);
+                        });
+                    });
+
+loop.run();
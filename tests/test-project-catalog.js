@@ -0,0 +1,33 @@
+const Zanata = imports.gi.Zanata;
+const GLib = imports.gi.GLib;
+
+let key_file = new GLib.KeyFile();
+key_file.load_from_file(GLib.build_filenamev([GLib.get_user_config_dir(),
+                                              'zanata.ini']),
+                        GLib.KeyFileFlags.NONE);
+
+let authorizer = new Zanata.KeyFileAuthorizer({ key_file: key_file });
+
+let session = new Zanata.Session({ authorizer: authorizer,
+                                   domain: 'translate_zanata_org' });
+
+let loop = GLib.MainLoop.new(null, false);
+
+session.get_project_catalog(null,
+                            function (s, res, d) {
+                                let catalog = s.get_project_catalog_finish(res);
+                                print(catalog.get_n_items());
+                                let active = catalog.filter(function (c, position) {
+                                    return c.get_status(position) == Zanata.ProjectStatus.ACTIVE;
+                                });
+                                print(active.get_n_items());
+                                for (let index = 0;
+                                     index < Math.min(active.get_n_items(), 10);
+                                     index++) {
+                                    let project = active.get_project(index);
+                                    print([project.name, project.id, project.status]);
+                                }
+                                loop.quit();
+                            });
+
+loop.run();
@@ -0,0 +1,40 @@
+const Zanata = imports.gi.Zanata;
+const GLib = imports.gi.GLib;
+
+let key_file = new GLib.KeyFile();
+key_file.load_from_file(GLib.build_filenamev([GLib.get_user_config_dir(),
+                                              'zanata.ini']),
+                        GLib.KeyFileFlags.NONE);
+
+let authorizer = new Zanata.KeyFileAuthorizer({ key_file: key_file });
+
+let session = new Zanata.Session({ authorizer: authorizer,
+                                   domain: 'translate_zanata_org' });
+
+let loop = GLib.MainLoop.new(null, false);
+let count = 0;
+
+function readBatch(stream) {
+    stream.next_async(100, null, function (s, res, d) {
+        let result = s.next_finish(res);
+        if (result.length == 0) {
+            print(count);
+            loop.quit();
+            return;
+        }
+        count += result.length;
+        for (let index in result) {
+            let project = result[index];
+            print([project.name, project.id, project.status]);
+        }
+        readBatch(s);
+    });
+}
+
+session.open_projects(null,
+                      function (s, res, d) {
+                          let stream = s.open_projects_finish(res);
+                          readBatch(stream);
+                      });
+
+loop.run();
@@ -0,0 +1,57 @@
+const Zanata = imports.gi.Zanata;
+const GLib = imports.gi.GLib;
+
+let key_file = new GLib.KeyFile();
+key_file.load_from_file(GLib.build_filenamev([GLib.get_user_config_dir(),
+                                              'zanata.ini']),
+                        GLib.KeyFileFlags.NONE);
+
+let authorizer = new Zanata.KeyFileAuthorizer({ key_file: key_file });
+
+let session = new Zanata.Session({ authorizer: authorizer,
+                                   domain: 'translate_zanata_org' });
+
+let loop = GLib.MainLoop.new(null, false);
+let count = 0;
+
+function readBatch(resource) {
+    resource.next_async(100, null, function (s, res, d) {
+        let result = s.next_finish(res);
+        let n_items = result.get_n_items();
+        if (n_items == 0) {
+            print(count);
+            loop.quit();
+            return;
+        }
+        count += n_items;
+        for (let index = 0; index < n_items; index++) {
+            let target = result.get_item(index);
+            print([target.res_id, target.state, target.contents]);
+        }
+        readBatch(s);
+    });
+}
+
+function openTranslationResource(iteration) {
+    iteration.open_translation_resource(
+        'coala', 'de-DE', null,
+        function (s, res, d) {
+            let resource = s.open_translation_resource_finish(res);
+            readBatch(resource);
+        });
+}
+
+session.get_project('coala', null,
+                    function (s, res, d) {
+                        let project = s.get_project_finish(res);
+                        project.get_iterations(null, function (s, res, d) {
+                            let result = s.get_iterations_finish(res);
+                            if (result.length == 0) {
+                                loop.quit();
+                                return;
+                            }
+                            openTranslationResource(result[result.length - 1]);
+                        });
+                    });
+
+loop.run();